@@ -0,0 +1,43 @@
+# cmake-format: off
+# 
+#           d8888 888                     d8888                          
+#          d88888 888                    d88888                          
+#         d88P888 888                   d88P888                          
+#        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b  
+#       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K      
+#      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b. 
+#     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88 
+#    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P' 
+#                                                           888          
+# ~$ Command Line Argument Processing Simplified       Y8b d88P          
+#                                                       "Y88P"           
+# Copyright (c) 2025, Abe Mishler
+# Licensed under the Universal Permissive License v 1.0
+# as shown at https://oss.oracle.com/licenses/upl/.              
+# 
+# cmake-format: on
+
+# cmake-format: off
+# abeargs_generate_parser(<target> <spec file> <output header>)
+#
+# Generate <output header> from <spec file> with the abeargs_gen tool and add
+# it to <target>. The header is regenerated whenever the spec file changes,
+# and the target gets the binary dir on its include path so it can
+# #include "<output header>".
+# cmake-format: on
+function(abeargs_generate_parser TARGET SPEC_FILE OUTPUT_HEADER)
+  get_filename_component(SPEC_PATH "${SPEC_FILE}" ABSOLUTE)
+  set(OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/abeargs_generated")
+  set(OUTPUT_PATH "${OUTPUT_DIR}/${OUTPUT_HEADER}")
+
+  add_custom_command(
+    OUTPUT "${OUTPUT_PATH}"
+    COMMAND ${CMAKE_COMMAND} -E make_directory "${OUTPUT_DIR}"
+    COMMAND abeargs_gen "${SPEC_PATH}" "${OUTPUT_PATH}"
+    DEPENDS "${SPEC_PATH}" abeargs_gen
+    COMMENT "Generating ${OUTPUT_HEADER} from ${SPEC_FILE}"
+    VERBATIM)
+
+  target_sources(${TARGET} PRIVATE "${OUTPUT_PATH}")
+  target_include_directories(${TARGET} PRIVATE "${OUTPUT_DIR}")
+endfunction()
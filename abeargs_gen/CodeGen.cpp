@@ -0,0 +1,485 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "CodeGen.h"
+
+// Standard includes
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <set>
+#include <sstream>
+
+namespace AbeArgsGen {
+
+namespace {
+
+const uint64_t FNV_OFFSET = 14695981039346656037ull;
+const uint64_t FNV_PRIME = 1099511628211ull;
+
+// The same hash is emitted into the generated matcher.
+uint64_t
+hashFlag(const std::string& p_flag, uint64_t p_seed)
+{
+    uint64_t h = FNV_OFFSET ^ p_seed;
+    for (const char c : p_flag) {
+        h ^= static_cast<unsigned char>(c);
+        h *= FNV_PRIME;
+    }
+    return h ^ (h >> 32);
+}
+
+std::string
+quote(const std::string& p_value)
+{
+    std::string result = "\"";
+    for (const char c : p_value) {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        if (c == '\n')
+            result += "\\n";
+        else if (c == '\t')
+            result += "\\t";
+        else
+            result += c;
+    }
+    return result + "\"";
+}
+
+bool
+isKeyword(const std::string& p_name)
+{
+    static const std::set<std::string> keywords = {
+        "auto", "bool", "break", "case", "char", "class", "const", "continue", "default", "delete",
+        "do", "double", "else", "enum", "false", "float", "for", "if", "int", "long", "namespace",
+        "new", "private", "public", "return", "short", "signed", "static", "struct", "switch",
+        "template", "this", "true", "typedef", "union", "unsigned", "using", "void", "while", "present"
+    };
+    return keywords.count(p_name) != 0;
+}
+
+const char*
+cppType(const std::string& p_value_type)
+{
+    if (p_value_type == "bool")
+        return "bool";
+    if (p_value_type == "int")
+        return "int";
+    if (p_value_type == "float")
+        return "float";
+    if (p_value_type == "double")
+        return "double";
+    return "std::string";
+}
+
+// The converters and helpers every generated parser uses.
+const char* s_detail_code = R"(namespace detail {
+
+inline bool
+toBool(std::string_view p_value, bool& p_result)
+{
+    static const char* const true_words[] = { "t", "true", "y", "yes", "1", "on" };
+    static const char* const false_words[] = { "f", "false", "n", "no", "0", "off" };
+    auto equals = [p_value](const char* p_word) {
+        const size_t len = std::strlen(p_word);
+        if (len != p_value.size())
+            return false;
+        for (size_t i = 0; i < len; ++i)
+            if (std::tolower(static_cast<unsigned char>(p_value[i])) != p_word[i])
+                return false;
+        return true;
+    };
+    for (const char* word : true_words)
+        if (equals(word))
+            return (p_result = true, true);
+    for (const char* word : false_words)
+        if (equals(word))
+            return (p_result = false, true);
+    return false;
+}
+
+inline bool
+toInt(std::string_view p_value, int& p_result)
+{
+    const auto [end, ec] = std::from_chars(p_value.data(), p_value.data() + p_value.size(), p_result);
+    return ec == std::errc{} && end == p_value.data() + p_value.size();
+}
+
+inline bool
+toFloat(std::string_view p_value, float& p_result)
+{
+    const std::string value{ p_value };
+    char* end = nullptr;
+    p_result = std::strtof(value.c_str(), &end);
+    return !value.empty() && *end == '\0';
+}
+
+inline bool
+toDouble(std::string_view p_value, double& p_result)
+{
+    const std::string value{ p_value };
+    char* end = nullptr;
+    p_result = std::strtod(value.c_str(), &end);
+    return !value.empty() && *end == '\0';
+}
+
+inline bool
+toFile(std::string_view p_value, std::string& p_result)
+{
+    p_result = p_value;
+    if (FILE* file = std::fopen(p_result.c_str(), "r")) {
+        std::fclose(file);
+        return true;
+    }
+    return false;
+}
+
+inline bool
+toString(std::string_view p_value, std::string& p_result)
+{
+    p_result = p_value;
+    return true;
+}
+
+struct FlagEntry
+{
+    const char* flag;
+    unsigned char length;
+    int id;
+};
+
+inline uint64_t
+hashFlag(std::string_view p_flag, uint64_t p_seed)
+{
+    uint64_t h = 14695981039346656037ull ^ p_seed;
+    for (const char c : p_flag) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h ^ (h >> 32);
+}
+
+} // namespace detail
+)";
+
+} // namespace
+
+CodeGen::CodeGen(const SpecFile& p_spec)
+  : m_spec(p_spec)
+{
+    for (size_t i = 0, n = m_spec.m_args.size(); i < n; ++i) {
+        for (const std::string& flag : { m_spec.getShortFlag(m_spec.m_args[i]), m_spec.getLongFlag(m_spec.m_args[i]) }) {
+            if (flag.empty())
+                continue;
+            m_flags.push_back(flag);
+            m_flag_owners.push_back(i);
+        }
+    }
+}
+
+// Search for a seed that sends every flag to its own slot of a power of two
+// table, so the generated matcher is one hash, one probe and one compare.
+bool
+CodeGen::findPerfectHash()
+{
+    size_t table_size = 1;
+    while (table_size < m_flags.size())
+        table_size <<= 1;
+
+    for (; table_size <= (size_t(1) << 20); table_size <<= 1) {
+        for (uint64_t seed = 0; seed < 100000; ++seed) {
+            std::vector<int> table(table_size, -1);
+            bool collision = false;
+            for (size_t f = 0; f < m_flags.size() && !collision; ++f) {
+                int& slot = table[hashFlag(m_flags[f], seed) & (table_size - 1)];
+                collision = (slot != -1);
+                slot = static_cast<int>(f);
+            }
+
+            if (!collision) {
+                m_seed = seed;
+                m_table_size = table_size;
+                m_table = table;
+                return true;
+            }
+        }
+    }
+
+    m_error_msg = "error: No perfect hash found for the flags";
+    return false;
+}
+
+bool
+CodeGen::emitDefault(const SpecArg& p_arg, std::string& p_literal)
+{
+    const std::string& type = p_arg.value_type;
+    const std::string& value = p_arg.default_value;
+    char* end = nullptr;
+
+    if (!p_arg.has_default) {
+        p_literal = (type == "bool") ? "false" : (type == "string" || type == "file") ? "{}" : "0";
+        return true;
+    }
+
+    if (type == "int") {
+        std::strtol(value.c_str(), &end, 10);
+        p_literal = value;
+    } else if (type == "float") {
+        std::strtof(value.c_str(), &end);
+        p_literal = value + ((value.find_first_of(".eE") == std::string::npos) ? ".f" : "f");
+    } else if (type == "double") {
+        std::strtod(value.c_str(), &end);
+        p_literal = value + ((value.find_first_of(".eE") == std::string::npos) ? ".0" : "");
+    } else if (type == "bool") {
+        const bool is_true = (value == "true" || value == "1" || value == "yes" || value == "on");
+        const bool is_false = (value == "false" || value == "0" || value == "no" || value == "off");
+        p_literal = is_true ? "true" : "false";
+        if (!is_true && !is_false) {
+            m_error_msg = "error: Invalid boolean default: " + value;
+            return false;
+        }
+        return true;
+    } else {
+        p_literal = quote(value);
+        return true;
+    }
+
+    if (value.empty() || *end != '\0') {
+        m_error_msg = "error: Invalid " + type + " default: " + value;
+        return false;
+    }
+
+    return true;
+}
+
+std::string
+CodeGen::fieldName(const SpecArg& p_arg) const
+{
+    const std::string& name = p_arg.long_name.empty() ? p_arg.short_name : p_arg.long_name;
+
+    std::string result;
+    for (const char c : name)
+        result += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+
+    if (std::isdigit(static_cast<unsigned char>(result[0])))
+        result = "opt_" + result;
+    if (isKeyword(result))
+        result += '_';
+
+    return result;
+}
+
+std::string
+CodeGen::idName(const SpecArg& p_arg) const
+{
+    std::string result = fieldName(p_arg);
+    for (char& c : result)
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    return result + "_ID";
+}
+
+// The same layout as Argument::toString().
+std::string
+CodeGen::helpText() const
+{
+    size_t longest_long_name = 0;
+    for (const SpecArg& arg : m_spec.m_args)
+        longest_long_name = std::max(longest_long_name, arg.long_name.length());
+
+    const std::string column_space = "   ";
+    std::string result;
+    for (const SpecArg& arg : m_spec.m_args) {
+        std::string short_flag = m_spec.getShortFlag(arg);
+        std::string long_flag = m_spec.getLongFlag(arg);
+        if (short_flag.empty())
+            short_flag = "  ";
+        if (long_flag.empty())
+            long_flag = m_spec.m_slash_style ? " " : "  ";
+
+        const std::string flags = short_flag + column_space + long_flag + column_space +
+                                  std::string(longest_long_name - arg.long_name.length(), ' ');
+        result += '\t' + flags + arg.description;
+        if (arg.arg_class == "required")
+            result += " (Required)";
+        if (arg.has_default)
+            result += "\n\t" + std::string(flags.length(), ' ') + "(default = " + arg.default_value + ")";
+        result += '\n';
+    }
+
+    return result;
+}
+
+bool
+CodeGen::generate(const std::string& p_spec_name, std::string& p_output)
+{
+    if (!findPerfectHash())
+        return false;
+
+    const std::vector<SpecArg>& args = m_spec.m_args;
+    const std::string& opts = m_spec.m_options_name;
+    std::ostringstream out;
+
+    out << "// Generated by abeargs_gen from " << p_spec_name << ". Do not edit.\n\n"
+        << "#pragma once\n\n"
+        << "// Standard includes\n"
+        << "#include <cctype>\n"
+        << "#include <charconv>\n"
+        << "#include <cstdint>\n"
+        << "#include <cstdio>\n"
+        << "#include <cstdlib>\n"
+        << "#include <cstring>\n"
+        << "#include <string>\n"
+        << "#include <string_view>\n\n"
+        << "namespace " << m_spec.m_namespace << " {\n\n";
+
+    // ---- The options struct ----
+    out << "struct " << opts << "\n{\n"
+        << "    enum ID : int\n    {\n";
+    for (const SpecArg& arg : args)
+        out << "        " << idName(arg) << ",\n";
+    out << "        NUM_OPTIONS,\n    };\n\n";
+
+    for (const SpecArg& arg : args) {
+        std::string literal;
+        if (!emitDefault(arg, literal)) {
+            m_error_msg += " (line " + std::to_string(arg.line_num) + ")";
+            return false;
+        }
+        out << "    /// @brief " << arg.description << '\n'
+            << "    " << cppType(arg.value_type) << ' ' << fieldName(arg) << " = " << literal << ";\n";
+    }
+
+    out << "\n    /// @brief Which options were given on the command line.\n"
+        << "    bool present[NUM_OPTIONS] = {};\n\n"
+        << "    bool has(ID p_id) const { return present[p_id]; }\n"
+        << "};\n\n";
+
+    // ---- The help text ----
+    out << "inline constexpr const char HELP_TEXT[] = " << quote(helpText()) << ";\n\n";
+
+    out << s_detail_code << '\n';
+
+    // ---- The perfect-hash matcher ----
+    out << "namespace detail {\n\n"
+        << "inline constexpr uint64_t FLAG_SEED = " << m_seed << "ull;\n"
+        << "inline constexpr FlagEntry FLAG_TABLE[" << m_table_size << "] = {\n";
+    for (size_t slot = 0; slot < m_table_size; ++slot) {
+        const int f = m_table[slot];
+        if (f < 0)
+            out << "    { nullptr, 0, -1 },\n";
+        else
+            out << "    { " << quote(m_flags[f]) << ", " << m_flags[f].length() << ", " << opts << "::" << idName(args[m_flag_owners[f]]) << " },\n";
+    }
+    out << "};\n\n"
+        << "inline int\nmatchFlag(std::string_view p_flag)\n{\n"
+        << "    const FlagEntry& entry = FLAG_TABLE[hashFlag(p_flag, FLAG_SEED) & " << (m_table_size - 1) << "];\n"
+        << "    if (entry.flag != nullptr && entry.length == p_flag.size() && std::memcmp(entry.flag, p_flag.data(), entry.length) == 0)\n"
+        << "        return entry.id;\n"
+        << "    return -1;\n"
+        << "}\n\n"
+        << "} // namespace detail\n\n";
+
+    // ---- parse() ----
+    out << "/// @brief Parse argv straight into the options struct.\n"
+        << "/// @return false with an error message on the first bad option\n"
+        << "inline bool\nparse(int p_argc, char* p_argv[], " << opts << "& p_options, std::string& p_error)\n{\n"
+        << "    for (int i = 1; i < p_argc; ++i) {\n"
+        << "        std::string_view token = p_argv[i];\n"
+        << "        std::string_view value;\n"
+        << "        bool has_value = false;\n"
+        << "        const size_t eq_pos = token.find('=');\n"
+        << "        if (eq_pos != std::string_view::npos) {\n"
+        << "            value = token.substr(eq_pos + 1);\n"
+        << "            token = token.substr(0, eq_pos);\n"
+        << "            has_value = true;\n"
+        << "        }\n\n"
+        << "        const int id = detail::matchFlag(token);\n"
+        << "        switch (id) {\n";
+
+    for (const SpecArg& arg : args) {
+        const std::string field = "p_options." + fieldName(arg);
+        out << "            case " << opts << "::" << idName(arg) << ":\n";
+        if (arg.arg_class == "switch" || arg.arg_class == "xswitch") {
+            out << "                if (has_value && !detail::toBool(value, " << field << ")) {\n"
+                << "                    p_error = \"error: Invalid boolean: \" + std::string(value);\n"
+                << "                    return false;\n"
+                << "                }\n"
+                << "                if (!has_value)\n"
+                << "                    " << field << " = true;\n";
+            if (arg.arg_class == "xswitch")
+                out << "                // Only handle the first exclusive switch, then return.\n"
+                    << "                p_options.present[id] = true;\n"
+                    << "                return true;\n";
+            else
+                out << "                break;\n";
+            continue;
+        }
+
+        std::string convert = "toString";
+        std::string type_name = "string";
+        if (arg.value_type == "file")
+            convert = "toFile", type_name = "file";
+        else if (arg.value_type == "bool")
+            convert = "toBool", type_name = "boolean";
+        else if (arg.value_type == "int")
+            convert = "toInt", type_name = "integer";
+        else if (arg.value_type == "float")
+            convert = "toFloat", type_name = "float";
+        else if (arg.value_type == "double")
+            convert = "toDouble", type_name = "double";
+
+        const std::string error_prefix = (type_name == "file") ? "error: File not found: " : "error: Invalid " + type_name + ": ";
+        out << "                if (!has_value) {\n"
+            << "                    if (i + 1 >= p_argc) {\n"
+            << "                        p_error = \"error: Missing value for option: \" + std::string(token);\n"
+            << "                        return false;\n"
+            << "                    }\n"
+            << "                    value = p_argv[++i];\n"
+            << "                }\n"
+            << "                if (!detail::" << convert << "(value, " << field << ")) {\n"
+            << "                    p_error = \"" << error_prefix << "\" + std::string(value);\n"
+            << "                    return false;\n"
+            << "                }\n"
+            << "                break;\n";
+    }
+
+    out << "            default:\n"
+        << "                p_error = \"error: Unrecognized command-line option: \" + std::string(p_argv[i]);\n"
+        << "                return false;\n"
+        << "        }\n"
+        << "        p_options.present[id] = true;\n"
+        << "    }\n\n";
+
+    for (const SpecArg& arg : args) {
+        if (arg.arg_class != "required")
+            continue;
+        const std::string flag = arg.long_name.empty() ? m_spec.getShortFlag(arg) : m_spec.getLongFlag(arg);
+        out << "    if (!p_options.present[" << opts << "::" << idName(arg) << "]) {\n"
+            << "        p_error = \"error: Missing required option: " << flag << "\";\n"
+            << "        return false;\n"
+            << "    }\n";
+    }
+
+    out << "    return true;\n"
+        << "}\n\n"
+        << "} // namespace " << m_spec.m_namespace << '\n';
+
+    p_output = out.str();
+    return true;
+}
+
+} // namespace AbeArgsGen
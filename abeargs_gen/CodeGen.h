@@ -0,0 +1,65 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Project includes
+#include "SpecFile.h"
+
+// Standard includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace AbeArgsGen {
+
+/// @brief Emits a self-contained C++ header for a spec file: an options
+///        struct, the help text as constants, a perfect-hash flag matcher and
+///        a parse() function that fills the struct straight from argv.
+class CodeGen
+{
+  public:
+    explicit CodeGen(const SpecFile& p_spec);
+
+    bool generate(const std::string& p_spec_name, std::string& p_output);
+
+    const std::string& getErrorMsg() const { return m_error_msg; }
+
+  private:
+    bool findPerfectHash();
+    bool emitDefault(const SpecArg& p_arg, std::string& p_literal);
+
+    std::string helpText() const;
+    std::string fieldName(const SpecArg& p_arg) const;
+    std::string idName(const SpecArg& p_arg) const;
+
+  private:
+    const SpecFile& m_spec;
+
+    /// @brief The flag strings and the index of the argument each belongs to.
+    std::vector<std::string> m_flags;
+    std::vector<size_t> m_flag_owners;
+
+    /// @brief The seed and table size that hash every flag to its own slot.
+    uint64_t m_seed = 0;
+    size_t m_table_size = 0;
+    std::vector<int> m_table;
+
+    std::string m_error_msg;
+};
+
+} // namespace AbeArgsGen
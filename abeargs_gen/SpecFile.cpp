@@ -0,0 +1,195 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "SpecFile.h"
+
+// Standard includes
+#include <fstream>
+#include <set>
+
+namespace AbeArgsGen {
+
+namespace {
+
+// Split a line into words. A double-quoted word may hold spaces, and
+// name=value words keep the quotes out of the value.
+bool
+splitWords(const std::string& p_line, std::vector<std::string>& p_words)
+{
+    std::string word;
+    bool in_word = false;
+    bool in_quotes = false;
+    for (const char c : p_line) {
+        if (in_quotes) {
+            if (c == '"')
+                in_quotes = false;
+            else
+                word += c;
+        } else if (c == '"') {
+            in_quotes = true;
+            in_word = true;
+        } else if (c == ' ' || c == '\t' || c == '\r') {
+            if (in_word)
+                p_words.push_back(word);
+            word.clear();
+            in_word = false;
+        } else if (c == '#' && !in_word) {
+            break;
+        } else {
+            word += c;
+            in_word = true;
+        }
+    }
+
+    if (in_word)
+        p_words.push_back(word);
+
+    return !in_quotes;
+}
+
+bool
+isValueType(const std::string& p_word)
+{
+    static const std::set<std::string> value_types = { "string", "file", "bool", "int", "float", "double" };
+    return value_types.count(p_word) != 0;
+}
+
+} // namespace
+
+bool
+SpecFile::read(const std::string& p_file_path)
+{
+    m_file_path = p_file_path;
+
+    std::ifstream file(p_file_path);
+    if (!file) {
+        m_error_msg = "error: File not found: " + p_file_path;
+        return false;
+    }
+
+    std::string line;
+    int line_num = 0;
+    while (std::getline(file, line))
+        if (!parseLine(line, ++line_num))
+            return false;
+
+    // Flags must be unique across the spec.
+    std::set<std::string> flags;
+    for (const SpecArg& arg : m_args)
+        for (const std::string& flag : { getShortFlag(arg), getLongFlag(arg) })
+            if (!flag.empty() && !flags.insert(flag).second)
+                return setError(arg.line_num, "Duplicate flag: " + flag);
+
+    return true;
+}
+
+std::string
+SpecFile::getShortFlag(const SpecArg& p_arg) const
+{
+    if (p_arg.short_name.empty())
+        return {};
+    return (m_slash_style ? "/" : "-") + p_arg.short_name;
+}
+
+std::string
+SpecFile::getLongFlag(const SpecArg& p_arg) const
+{
+    if (p_arg.long_name.empty())
+        return {};
+    return (m_slash_style ? "/" : "--") + p_arg.long_name;
+}
+
+bool
+SpecFile::parseLine(const std::string& p_line, int p_line_num)
+{
+    std::vector<std::string> words;
+    if (!splitWords(p_line, words))
+        return setError(p_line_num, "Unterminated quote");
+
+    if (words.empty())
+        return true;
+
+    const std::string& keyword = words[0];
+    if (keyword == "namespace" || keyword == "options" || keyword == "style") {
+        if (words.size() != 2)
+            return setError(p_line_num, "Expected one value for " + keyword);
+
+        if (keyword == "namespace")
+            m_namespace = words[1];
+        else if (keyword == "options")
+            m_options_name = words[1];
+        else if (words[1] == "slash" || words[1] == "dash")
+            m_slash_style = (words[1] == "slash");
+        else
+            return setError(p_line_num, "Unknown style: " + words[1]);
+
+        return true;
+    }
+
+    if (keyword != "switch" && keyword != "xswitch" && keyword != "optional" && keyword != "required")
+        return setError(p_line_num, "Unknown keyword: " + keyword);
+
+    SpecArg arg;
+    arg.arg_class = keyword;
+    arg.line_num = p_line_num;
+
+    // <class> <short> <long> [<type>] "<description>" [default=<value>]
+    size_t w = 1;
+    if (words.size() < 4)
+        return setError(p_line_num, "Expected: " + keyword + " <short> <long> [type] \"description\"");
+
+    arg.short_name = (words[w] == "-") ? std::string{} : words[w];
+    ++w;
+    arg.long_name = (words[w] == "-") ? std::string{} : words[w];
+    ++w;
+    if (arg.short_name.empty() && arg.long_name.empty())
+        return setError(p_line_num, "An argument needs a short or a long name");
+
+    const bool is_switch = (keyword == "switch" || keyword == "xswitch");
+    if (is_switch)
+        arg.value_type = "bool";
+    else if (isValueType(words[w]))
+        arg.value_type = words[w++];
+    else
+        // Optional and required arguments default to strings.
+        arg.value_type = "string";
+
+    if (w >= words.size())
+        return setError(p_line_num, "Missing description");
+    arg.description = words[w++];
+
+    for (; w < words.size(); ++w) {
+        const std::string& word = words[w];
+        if (word.rfind("default=", 0) == 0 && !is_switch) {
+            arg.default_value = word.substr(8);
+            arg.has_default = true;
+        } else
+            return setError(p_line_num, "Unexpected word: " + word);
+    }
+
+    m_args.push_back(arg);
+    return true;
+}
+
+bool
+SpecFile::setError(int p_line_num, const std::string& p_msg)
+{
+    m_error_msg = "error: " + m_file_path + ":" + std::to_string(p_line_num) + ": " + p_msg;
+    return false;
+}
+
+} // namespace AbeArgsGen
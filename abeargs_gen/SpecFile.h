@@ -0,0 +1,82 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Standard includes
+#include <string>
+#include <vector>
+
+namespace AbeArgsGen {
+
+/// @brief One argument declared in a spec file.
+struct SpecArg
+{
+    /// @brief switch, xswitch, optional or required.
+    std::string arg_class;
+    /// @brief The short and long flag names without the dashes or slash (empty when not given).
+    std::string short_name;
+    std::string long_name;
+    /// @brief string, file, bool, int, float or double (bool for switches).
+    std::string value_type;
+    std::string description;
+    std::string default_value;
+    bool has_default = false;
+    /// @brief The line of the spec file the argument was declared on.
+    int line_num = 0;
+};
+
+/// @brief The declarations read from a spec file.
+///
+/// The spec is line oriented. Blank lines and lines that start with '#' are
+/// skipped. A line is either a setting or an argument:
+///
+///     namespace myapp
+///     options AppOptions
+///     style dash|slash
+///     switch   v verbose        "Verbose output"
+///     xswitch  h help           "Show this info"
+///     optional t threads int    "Number of threads" default=4
+///     required i input   file   "Input file"
+///
+/// A '-' in place of a short or long name leaves that flag out.
+class SpecFile
+{
+  public:
+    bool read(const std::string& p_file_path);
+
+    const std::string& getErrorMsg() const { return m_error_msg; }
+
+    std::string getShortFlag(const SpecArg& p_arg) const;
+    std::string getLongFlag(const SpecArg& p_arg) const;
+
+  public:
+    std::string m_namespace = "abeargs_gen";
+    std::string m_options_name = "Options";
+    bool m_slash_style = false;
+    std::vector<SpecArg> m_args;
+
+  private:
+    bool parseLine(const std::string& p_line, int p_line_num);
+    bool setError(int p_line_num, const std::string& p_msg);
+
+  private:
+    std::string m_file_path;
+    std::string m_error_msg;
+};
+
+} // namespace AbeArgsGen
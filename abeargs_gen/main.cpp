@@ -0,0 +1,80 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+// Project includes
+#include "CodeGen.h"
+#include "SpecFile.h"
+
+// Standard includes
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+/**
+ * @brief Generate a specialized parser header from a spec file.
+ *
+ * Usage: abeargs_gen <spec file> <output header>
+ *
+ * The output is only rewritten when its content changes, so targets that
+ * include it don't rebuild needlessly.
+ *
+ * @return int Returns 0 on success, otherwise returns 1.
+ */
+int
+main(int argc, char* argv[])
+{
+    using namespace AbeArgsGen;
+
+    if (argc != 3) {
+        std::cerr << "usage: abeargs_gen <spec file> <output header>\n";
+        return 1;
+    }
+
+    const std::string spec_path = argv[1];
+    const std::string output_path = argv[2];
+
+    SpecFile spec;
+    if (!spec.read(spec_path)) {
+        std::cerr << spec.getErrorMsg() << '\n';
+        return 1;
+    }
+
+    CodeGen code_gen(spec);
+    std::string output;
+    const std::string spec_name = spec_path.substr(spec_path.find_last_of("/\\") + 1);
+    if (!code_gen.generate(spec_name, output)) {
+        std::cerr << code_gen.getErrorMsg() << '\n';
+        return 1;
+    }
+
+    {
+        std::ifstream existing(output_path, std::ios::binary);
+        const std::string existing_output{ std::istreambuf_iterator<char>(existing), std::istreambuf_iterator<char>() };
+        if (existing_output == output)
+            return 0;
+    }
+
+    std::ofstream file(output_path, std::ios::binary | std::ios::trunc);
+    file << output;
+    if (!file) {
+        std::cerr << "error: Unable to write: " << output_path << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -17,15 +17,131 @@
 
 #include "Argument.h"
 
+// Project includes
+#include "FlagStyle.h"
+
+// Standard includes
+#include <algorithm>
+#include <charconv>
+
 namespace AbeArgs {
 
-static size_t s_longest_long_name = 0;
+// Numbers are written in their shortest form (0.25, not 0.250000).
+std::string
+valueToString(const VarValue_t& p_value)
+{
+    char buffer[32];
+    std::to_chars_result result{ buffer, {} };
+
+    switch (p_value.index()) {
+        case 0:
+            return std::get<bool>(p_value) ? "true" : "false";
+        case 1:
+            result = std::to_chars(buffer, buffer + sizeof(buffer), std::get<int>(p_value));
+            break;
+        case 2:
+            result = std::to_chars(buffer, buffer + sizeof(buffer), std::get<float>(p_value));
+            break;
+        case 3:
+            result = std::to_chars(buffer, buffer + sizeof(buffer), std::get<double>(p_value));
+            break;
+        case 4:
+            return std::get<std::string>(p_value);
+        default: {
+            std::string text;
+            for (const int value : std::get<IntList_t>(p_value)) {
+                if (!text.empty())
+                    text += ',';
+                result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                text.append(buffer, result.ptr);
+            }
+            return text;
+        }
+    }
+
+    return std::string(buffer, result.ptr);
+}
+
+namespace {
+
+void
+appendBound(std::string& p_text, double p_bound)
+{
+    p_text += valueToString(p_bound);
+}
+
+} // namespace
+
+void
+Validation::addInterval(const Interval& p_interval)
+{
+    m_intervals.push_back(p_interval);
+
+    if (!m_range_text.empty())
+        m_range_text += " or ";
+    m_range_text += p_interval.low_open ? '(' : '[';
+    appendBound(m_range_text, p_interval.low);
+    m_range_text += ", ";
+    appendBound(m_range_text, p_interval.high);
+    m_range_text += p_interval.high_open ? ')' : ']';
+}
+
+void
+Validation::setLengthLimits(size_t p_min, size_t p_max)
+{
+    m_min_length = p_min;
+    m_max_length = p_max;
+    m_length_text = std::to_string(p_min) + " to " + std::to_string(p_max) + " characters";
+}
+
+void
+Validation::addPredicate(const Predicate_t& p_predicate)
+{
+    m_predicates.push_back(p_predicate);
+}
+
+bool
+Validation::inRange(double p_number) const
+{
+    for (const Interval& interval : m_intervals)
+        if (interval.contains(p_number))
+            return true;
+    return false;
+}
+
+// Only compares: nothing is allocated.
+ErrorCode
+Validation::check(const VarValue_t& p_value) const
+{
+    const size_t index = p_value.index();
+    if (index >= 1 && index <= 3 && !m_intervals.empty()) {
+        double number = 0.0;
+        assignValue(number, p_value);
+        if (!inRange(number))
+            return OUT_OF_RANGE;
+    } else if (index == 5 && !m_intervals.empty()) {
+        // Every value of a list must be in range.
+        for (const int value : std::get<IntList_t>(p_value))
+            if (!inRange(value))
+                return OUT_OF_RANGE;
+    } else if (index == 4) {
+        const size_t length = std::get<std::string>(p_value).size();
+        if (length < m_min_length || length > m_max_length)
+            return INVALID_LENGTH;
+    }
+
+    for (const Predicate_t& predicate : m_predicates)
+        if (!predicate(p_value))
+            return FAILED_CHECK;
+
+    return NO_ERRORS;
+}
 
 Argument::Argument(ArgumentType p_arg_class,
                    int p_arg_ID,
-                   const std::string& p_short_flag_name,
-                   const std::string& p_long_flag_name,
-                   const std::string& p_description,
+                   std::string_view p_short_flag_name,
+                   std::string_view p_long_flag_name,
+                   std::string_view p_description,
                    ArgumentType p_value_type,
                    size_t p_num_params)
   : m_arg_ID(p_arg_ID)
@@ -38,14 +154,10 @@ Argument::Argument(ArgumentType p_arg_class,
 {
     initValueType();
 
-    // By default, optional and required args have 1 param (flag = param).
-    if (p_arg_class == OPTIONAL || p_arg_class == REQUIRED)
+    // By default, optional, required and positional args have 1 param (flag = param).
+    if (p_arg_class == OPTIONAL || p_arg_class == REQUIRED || p_arg_class == POSITIONAL)
         if (m_num_params == DEFAULT_NUM_FLAG_PARAMS)
             m_num_params = 1;
-
-    if (DEFAULT_LONG_FLAG_NAME != m_long_flag_name)
-        if (m_long_flag_name.length() > s_longest_long_name)
-            s_longest_long_name = m_long_flag_name.length();
 }
 
 std::string
@@ -65,6 +177,8 @@ Argument::getDefaultValueToString() const
         result = to_string(get<double>(m_default_value));
     else if (index == 4)
         result = get<string>(m_default_value);
+    else if (index == 5)
+        result = valueToString(m_default_value);
 
     return result;
 }
@@ -77,63 +191,143 @@ Argument::setDefaultValue(VarValue_t p_value)
     return *this;
 }
 
+Argument&
+Argument::setEnvVar(const std::string& p_name)
+{
+    m_env_var = p_name;
+    return *this;
+}
+
+Argument&
+Argument::setDuplicatePolicy(ArgumentType p_policy)
+{
+    if (p_policy == ACCUMULATE &&
+        (m_value_type == BOOLEAN_TYPE || m_value_type == FLOAT_TYPE || m_value_type == DOUBLE_TYPE))
+        return *this;
+    m_duplicate_policy = p_policy;
+    return *this;
+}
+
+Argument&
+Argument::setChoices(const std::vector<Choice_t>& p_choices, bool p_ignore_case)
+{
+    m_choices = std::make_shared<const ChoiceTable>(p_choices, p_ignore_case);
+    return *this;
+}
+
+Argument&
+Argument::setRange(double p_min, double p_max)
+{
+    return addInterval({ p_min, p_max });
+}
+
+Argument&
+Argument::addInterval(const Interval& p_interval)
+{
+    editValidation().addInterval(p_interval);
+    return *this;
+}
+
+Argument&
+Argument::setLengthLimits(size_t p_min, size_t p_max)
+{
+    editValidation().setLengthLimits(p_min, p_max);
+    return *this;
+}
+
+Argument&
+Argument::addPredicate(const Predicate_t& p_predicate)
+{
+    editValidation().addPredicate(p_predicate);
+    return *this;
+}
+
+// Copy the limits before changing them if another copy of the argument shares them.
+Validation&
+Argument::editValidation()
+{
+    if (m_validation == nullptr)
+        m_validation = std::make_shared<Validation>();
+    else if (m_validation.use_count() > 1)
+        m_validation = std::make_shared<Validation>(*m_validation);
+
+    return *m_validation;
+}
+
+Argument&
+Argument::setListOrder(bool p_sort, bool p_unique)
+{
+    m_sorted_list = p_sort;
+    m_unique_list = p_unique;
+    return *this;
+}
+
+Argument&
+Argument::setCountable(bool p_countable)
+{
+    m_countable = p_countable;
+    return *this;
+}
+
 void
 Argument::setFlagType(ArgumentType p_flag_type)
 {
-    if (p_flag_type == m_flag_type)
-        return;
-
     m_flag_type = p_flag_type;
+}
 
-    if (m_flag_type == DASH_FLAG) {
-        m_short_flag_chars = DEFAULT_SHORT_DASH_CHARS;
-        m_long_flag_chars = DEFAULT_LONG_DASH_CHARS;
-    } else if (m_flag_type == SLASH_FLAG) {
-        m_short_flag_chars = DEFAULT_SHORT_SLASH_CHARS;
-        m_long_flag_chars = DEFAULT_LONG_SLASH_CHARS;
-    }
+std::string_view
+Argument::getShortFlagChars() const
+{
+    return shortFlagChars(m_flag_type);
+}
+
+std::string_view
+Argument::getLongFlagChars() const
+{
+    return longFlagChars(m_flag_type);
 }
 
 std::string
 Argument::getShortFlag() const
 {
-    return m_short_flag_chars + m_short_flag_name;
+    return std::string(getShortFlagChars()) + m_short_flag_name;
 }
 
 std::string
 Argument::getLongFlag() const
 {
-    return m_long_flag_chars + m_long_flag_name;
+    return std::string(getLongFlagChars()) + m_long_flag_name;
 }
 
 bool
-Argument::matchesDefaultFlag(const std::string& p_value) const
+Argument::matchesDefaultFlag(std::string_view p_value) const
 {
-    const bool arg_has_long_default = (m_long_flag_name == DEFAULT_LONG_FLAG_NAME);
-    const bool arg_has_short_default = (m_short_flag_name == DEFAULT_SHORT_FLAG_NAME);
-    const bool value_is_long_default = (p_value.compare(m_long_flag_chars + DEFAULT_LONG_FLAG_NAME) == 0);
-    const bool value_is_short_default = (p_value.compare(m_short_flag_chars + DEFAULT_SHORT_FLAG_NAME) == 0);
-    return (arg_has_long_default && value_is_long_default) ||
-           (arg_has_short_default && value_is_short_default);
+    FlagName flag;
+    if (!stripFlagChars(m_flag_type, p_value, flag))
+        return false;
+
+    const bool value_is_long_default = flag.is_long && (flag.name == DEFAULT_LONG_FLAG_NAME);
+    const bool value_is_short_default = flag.is_short && (flag.name == DEFAULT_SHORT_FLAG_NAME);
+    return (value_is_long_default && m_long_flag_name == DEFAULT_LONG_FLAG_NAME) ||
+           (value_is_short_default && m_short_flag_name == DEFAULT_SHORT_FLAG_NAME);
 }
 
+// Compare the bare names, without building the flags.
 bool
-Argument::matchesFlag(const std::string& p_value) const
+Argument::matchesFlag(std::string_view p_value) const
 {
-    const std::string short_flag = m_short_flag_chars + m_short_flag_name;
-    const std::string long_flag = m_long_flag_chars + m_long_flag_name;
-
-    const bool matches_short = (p_value == short_flag);
-    const bool matches_long = (p_value == long_flag);
+    FlagName flag;
+    if (isPositional() || isVariadic() || !stripFlagChars(m_flag_type, p_value, flag))
+        return false;
 
-    return matches_short || matches_long;
+    return (flag.is_short && flag.name == m_short_flag_name) || (flag.is_long && flag.name == m_long_flag_name);
 }
 
 std::string
-Argument::toString() const
+Argument::toString(size_t p_long_name_width) const
 {
     std::string long_flag_name = m_long_flag_name;
-    std::string long_flag_chars = m_long_flag_chars;
+    std::string long_flag_chars{ getLongFlagChars() };
 
     if (DEFAULT_LONG_FLAG_NAME == m_long_flag_name) {
         long_flag_name = {};
@@ -141,14 +335,17 @@ Argument::toString() const
     }
 
     const std::string column_space = "   ";
-    const size_t space_diff = s_longest_long_name - long_flag_name.length();
+    // Line the descriptions up after the longest long name (given by the caller).
+    const size_t space_diff = std::max(p_long_name_width, long_flag_name.length()) - long_flag_name.length();
 
     std::string spaces = column_space;
     for (int i = 0; i < space_diff; ++i)
         spaces += " ";
 
-    const std::string flags = m_short_flag_chars + m_short_flag_name + column_space +
-                              long_flag_chars + long_flag_name + spaces;
+    std::string flags = getShortFlag() + column_space + long_flag_chars + long_flag_name + spaces;
+    if (isPositional() || isVariadic())
+        // Positional arguments have no flags, so show their names in the flags' place.
+        flags = "<" + m_long_flag_name + (isVariadic() ? ">..." : ">") + spaces;
     const size_t flags_len = flags.length();
     std::string flags_space{};
     for (int i = 0; i < flags_len; ++i)
@@ -159,6 +356,9 @@ Argument::toString() const
     if (isRequired())
         str_result += " (Required)";
 
+    if (m_choices != nullptr)
+        str_result += "\n\t" + flags_space + "(one of: " + m_choices->getNames() + ")";
+
     if (hasDefaultValue())
         str_result += "\n\t" + flags_space + "(default = " + getDefaultValueToString() + ")";
 
@@ -179,8 +379,10 @@ Argument::initValueType()
         // Ensure the SWITCH class is of BOOLEAN type.
         m_value_type = ArgumentType::BOOLEAN_TYPE;
     else if (ArgumentType::OPTIONAL == m_class ||
-             ArgumentType::REQUIRED == m_class)
-        // Set the real default to be a STRING type for OPTIONAL and REQUIRED.
+             ArgumentType::REQUIRED == m_class ||
+             ArgumentType::POSITIONAL == m_class ||
+             ArgumentType::VARIADIC == m_class)
+        // Set the real default to be a STRING type for the classes that take values.
         m_value_type = ArgumentType::STRING_TYPE;
 }
 
@@ -18,15 +18,95 @@
 #pragma once
 
 // Project includes
+#include "ChoiceTable.h"
 #include "Defaults.h"
+#include "Diagnostic.h"
+#include "IntegerList.h"
 
 // Standard includes
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
 #include <variant>
+#include <vector>
 
 namespace AbeArgs {
 
-typedef std::variant<bool, int, float, double, std::string> VarValue_t;
+typedef std::variant<bool, int, float, double, std::string, IntList_t> VarValue_t;
+
+/// @brief Writes a parsed value to where an argument is bound. The options
+///        struct is only used by bindings to a member of one.
+typedef std::function<void(void* p_options, const std::type_info& p_options_type, const VarValue_t& p_value)> Binding_t;
+
+std::string valueToString(const VarValue_t& p_value);
+
+/// @brief Assign a parsed value to a variable, converting between number types.
+template<class T>
+void
+assignValue(T& p_target, const VarValue_t& p_value)
+{
+    std::visit(
+      [&p_target](const auto& value) {
+          typedef std::decay_t<decltype(value)> Value_t;
+          if constexpr (std::is_same_v<Value_t, T>)
+              p_target = value;
+          else if constexpr (std::is_arithmetic_v<Value_t> && std::is_arithmetic_v<T>)
+              p_target = static_cast<T>(value);
+      },
+      p_value);
+}
+
+/// @brief A range of numbers. An open end excludes its bound: (0, 1] is { 0, 1, true, false }.
+struct Interval
+{
+    double low = 0.0;
+    double high = 0.0;
+    bool low_open = false;
+    bool high_open = false;
+
+    bool contains(double p_value) const
+    {
+        return (low_open ? p_value > low : p_value >= low) && (high_open ? p_value < high : p_value <= high);
+    }
+};
+
+/// @brief A custom check of a converted value.
+typedef std::function<bool(const VarValue_t& p_value)> Predicate_t;
+
+/// @brief Limits on an argument's value, checked as soon as it's converted.
+class Validation
+{
+  public:
+    void addInterval(const Interval& p_interval);
+    void setLengthLimits(size_t p_min, size_t p_max);
+    void addPredicate(const Predicate_t& p_predicate);
+
+    ErrorCode check(const VarValue_t& p_value) const;
+    bool inRange(double p_number) const;
+
+    /// @brief The allowed values for a diagnostic ("[1, 256]", "1 to 8 characters").
+    const std::string& getRangeText() const { return m_range_text; }
+    const std::string& getLengthText() const { return m_length_text; }
+
+    const std::vector<Interval>& getIntervals() const { return m_intervals; }
+    bool hasLengthLimits() const { return !m_length_text.empty(); }
+    size_t getMinLength() const { return m_min_length; }
+    size_t getMaxLength() const { return m_max_length; }
+    bool hasPredicates() const { return !m_predicates.empty(); }
+
+  private:
+    /// @brief A number must be in one of the intervals (if there are any).
+    std::vector<Interval> m_intervals;
+    size_t m_min_length = 0;
+    size_t m_max_length = static_cast<size_t>(-1);
+    std::vector<Predicate_t> m_predicates;
+
+    std::string m_range_text;
+    std::string m_length_text;
+};
 
 /// @brief Command line argument type info.
 enum ArgumentType : int
@@ -66,6 +146,37 @@ enum ArgumentType : int
     DOUBLE_TYPE,
     /// @brief A filename represented by a string type.
     FILE_TYPE,
+    /// @brief The value came from the argument's registered default.
+    DEFAULT_SOURCE,
+    /// @brief The value came from a config file.
+    FILE_SOURCE,
+    /// @brief The value came from an environment variable.
+    ENV_SOURCE,
+    /// @brief The value came from the command line.
+    ARGV_SOURCE,
+    /// @brief A repeated flag keeps its first value.
+    FIRST_WINS,
+    /// @brief A repeated flag replaces its value (default).
+    LAST_WINS,
+    /// @brief A repeated flag is an error.
+    DUPLICATE_ERROR,
+    /// @brief A repeated flag adds its value to a list: an IntList_t for integers and choices
+    ///        (given as a list from the first value on), comma separated text for strings.
+    ACCUMULATE,
+    /// @brief One of a set of words (see Argument::setChoices), given as the word's integer value.
+    CHOICE_TYPE,
+    /// @brief A comma separated list of integers and ranges (1,5,10-20:2), given as an IntList_t.
+    INTEGER_LIST_TYPE,
+    /// @brief KEY=VALUE entries collected from every occurrence of the flag (see Parser::getValueMap),
+    ///        given as the number of entries. The duplicate policy applies to repeated keys.
+    MAP_TYPE,
+    /// @brief A class of argument given by its place on the command line instead of a flag.
+    ///        Positional arguments are filled in the order they're added, each with its
+    ///        num_params tokens, and they're required.
+    POSITIONAL,
+    /// @brief A class of argument that takes the rest of the command line once the positional
+    ///        arguments are filled (see Parser::getVariadicArgs), given as the number of tokens.
+    VARIADIC,
     /// @brief TODO: An IP address type.
     // IPADDR_TYPE,
 };
@@ -76,9 +187,9 @@ class Argument
     Argument() = default;
     Argument(ArgumentType p_arg_class,
              int p_arg_ID,
-             const std::string& p_short_flag_name = DEFAULT_SHORT_FLAG_NAME,
-             const std::string& p_long_flag_name = DEFAULT_LONG_FLAG_NAME,
-             const std::string& p_description = DEFAULT_FLAG_DESC,
+             std::string_view p_short_flag_name = DEFAULT_SHORT_FLAG_NAME,
+             std::string_view p_long_flag_name = DEFAULT_LONG_FLAG_NAME,
+             std::string_view p_description = DEFAULT_FLAG_DESC,
              ArgumentType p_value_type = ArgumentType::DEFAULT_VALUE_TYPE,
              size_t p_num_params = DEFAULT_NUM_FLAG_PARAMS);
     ~Argument() = default;
@@ -88,7 +199,7 @@ class Argument
     ArgumentType getClass() const { return m_class; }
     ArgumentType getValueType() const { return m_value_type; }
 
-    VarValue_t getDefaultValue() const { return m_default_value; }
+    const VarValue_t& getDefaultValue() const { return m_default_value; }
     std::string getDefaultValueToString() const;
     Argument& setDefaultValue(VarValue_t p_value);
     bool hasDefaultValue() const { return m_has_default_value; }
@@ -97,25 +208,91 @@ class Argument
     bool isXSwitch() const { return X_SWITCH == m_class; }
     bool isSwitch() const { return SWITCH == m_class; }
     bool isOptional() const { return OPTIONAL == m_class; }
-    bool isRequired() const { return REQUIRED == m_class; }
+    bool isRequired() const { return REQUIRED == m_class || POSITIONAL == m_class; }
+    bool isPositional() const { return POSITIONAL == m_class; }
+    bool isVariadic() const { return VARIADIC == m_class; }
 
     size_t getNumParams() const { return m_num_params; }
 
+    std::string getEnvVar() const { return m_env_var; }
+    Argument& setEnvVar(const std::string& p_name);
+    bool hasEnvVar() const { return !m_env_var.empty(); }
+
+    ArgumentType getDuplicatePolicy() const { return m_duplicate_policy; }
+    /// @brief Set what a repeated flag does. Booleans, floats and doubles have no list
+    ///        to ACCUMULATE into, so they keep their policy.
+    Argument& setDuplicatePolicy(ArgumentType p_policy);
+
+    /// @brief The words a CHOICE_TYPE argument accepts and the value each one gives.
+    Argument& setChoices(const std::vector<Choice_t>& p_choices, bool p_ignore_case = false);
+    const ChoiceTable* getChoices() const { return m_choices.get(); }
+
+    /// @brief Limit a number to [p_min, p_max].
+    Argument& setRange(double p_min, double p_max);
+    /// @brief Allow a number in this interval (a number must be in one of them).
+    Argument& addInterval(const Interval& p_interval);
+    /// @brief Limit the length of a string value.
+    Argument& setLengthLimits(size_t p_min, size_t p_max);
+    /// @brief Reject a value the predicate returns false for.
+    Argument& addPredicate(const Predicate_t& p_predicate);
+    const Validation* getValidation() const { return m_validation.get(); }
+
+    /// @brief Sort an INTEGER_LIST_TYPE value and/or drop its repeated values.
+    Argument& setListOrder(bool p_sort, bool p_unique);
+    bool isSortedList() const { return m_sorted_list; }
+    bool isUniqueList() const { return m_unique_list; }
+
+    bool isCountable() const { return m_countable; }
+    Argument& setCountable(bool p_countable = true);
+
+    /// @brief Write the parsed value straight to a variable (see Parser::execInto).
+    template<class T>
+    Argument& bind(T* p_target)
+    {
+        m_binding = [p_target](void*, const std::type_info&, const VarValue_t& p_value) {
+            assignValue(*p_target, p_value);
+        };
+        return *this;
+    }
+
+    /// @brief Write the parsed value to a member of the options struct given to Parser::execInto.
+    template<class Options_t, class T>
+    Argument& bind(T Options_t::*p_member)
+    {
+        m_binding = [p_member](void* p_options, const std::type_info& p_options_type, const VarValue_t& p_value) {
+            if (p_options != nullptr && p_options_type == typeid(Options_t))
+                assignValue(static_cast<Options_t*>(p_options)->*p_member, p_value);
+        };
+        return *this;
+    }
+
+    bool isBound() const { return static_cast<bool>(m_binding); }
+    void writeBinding(void* p_options, const std::type_info& p_options_type, const VarValue_t& p_value) const
+    {
+        m_binding(p_options, p_options_type, p_value);
+    }
+
     void setFlagType(ArgumentType flag_type);
 
-    std::string getLongFlagChars() const { return m_long_flag_chars; }
-    std::string getShortFlagChars() const { return m_short_flag_chars; }
+    std::string_view getLongFlagChars() const;
+    std::string_view getShortFlagChars() const;
 
     std::string getShortFlag() const;
     std::string getLongFlag() const;
 
-    bool matchesDefaultFlag(const std::string& p_value) const;
-    bool matchesFlag(const std::string& p_value) const;
+    const std::string& getShortFlagName() const { return m_short_flag_name; }
+    const std::string& getLongFlagName() const { return m_long_flag_name; }
+    const std::string& getDescription() const { return m_description; }
+    ArgumentType getFlagType() const { return m_flag_type; }
+
+    bool matchesDefaultFlag(std::string_view p_value) const;
+    bool matchesFlag(std::string_view p_value) const;
 
-    std::string toString() const;
+    std::string toString(size_t p_long_name_width = 0) const;
 
   private:
     void initValueType();
+    Validation& editValidation();
 
   private:
     /// @brief The identifier for the argument.
@@ -124,9 +301,9 @@ class Argument
     /// @brief Whether this is a switch, optional, or required class of argument.
     ArgumentType m_class = NO_ARG;
 
-    std::string m_short_flag_name = DEFAULT_SHORT_FLAG_NAME;
-    std::string m_long_flag_name = DEFAULT_LONG_FLAG_NAME;
-    std::string m_description = DEFAULT_FLAG_DESC;
+    std::string m_short_flag_name{ DEFAULT_SHORT_FLAG_NAME };
+    std::string m_long_flag_name{ DEFAULT_LONG_FLAG_NAME };
+    std::string m_description{ DEFAULT_FLAG_DESC };
 
     /// @brief The argument's value type (boolean, integer, double, string, filename).
     ArgumentType m_value_type = DEFAULT_VALUE_TYPE;
@@ -134,16 +311,32 @@ class Argument
     bool m_has_default_value = false;
     VarValue_t m_default_value{ false };
 
+    /// @brief Dashes (the default) or slashes before the flag names.
     ArgumentType m_flag_type = DASH_FLAG;
 
-    /// @brief The default way to signify a short flag is with a dash.
-    std::string m_short_flag_chars = DEFAULT_SHORT_DASH_CHARS;
-
-    /// @brief The default way to signify a long flag is with dashes.
-    std::string m_long_flag_chars = DEFAULT_LONG_DASH_CHARS;
-
     /// @brief The number of params (0 or 1 for switch, 1 for optional and required).
     size_t m_num_params = DEFAULT_NUM_FLAG_PARAMS;
+
+    /// @brief The environment variable to fall back on when the flag isn't on the command line.
+    std::string m_env_var = {};
+
+    /// @brief What a repeated flag does (FIRST_WINS, LAST_WINS, DUPLICATE_ERROR or ACCUMULATE).
+    ArgumentType m_duplicate_policy = LAST_WINS;
+
+    /// @brief Shared between copies of the argument (it doesn't change after it's built).
+    std::shared_ptr<const ChoiceTable> m_choices = {};
+
+    /// @brief The value's limits, shared between copies of the argument until one of them changes.
+    std::shared_ptr<Validation> m_validation = {};
+
+    bool m_sorted_list = false;
+    bool m_unique_list = false;
+
+    /// @brief A switch that counts its occurrences (-vvv gives 3) instead of being true.
+    bool m_countable = false;
+
+    /// @brief Where the parsed value is written by Parser::execInto.
+    Binding_t m_binding = {};
 };
 
 } // namespace AbeArgs
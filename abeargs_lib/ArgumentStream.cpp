@@ -0,0 +1,63 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "ArgumentStream.h"
+
+namespace AbeArgs {
+
+ArgumentStream::ArgumentStream(Parser& p_parser, int p_argc, char* p_argv[])
+  : m_parser(p_parser)
+  , m_tokenizer(p_argc, p_argv)
+{
+    m_parser.beginParse();
+}
+
+ArgumentStream::ArgumentStream(Parser& p_parser, std::string p_argv)
+  : m_parser(p_parser)
+  , m_argv(std::move(p_argv))
+  , m_tokenizer(m_argv)
+{
+    m_parser.beginParse();
+}
+
+bool
+ArgumentStream::next(std::pair<int, VarValue_t>& p_result)
+{
+    while (m_pending_pos == m_pending.size()) {
+        if (m_done)
+            return false;
+
+        m_pending.clear();
+        m_pending_pos = 0;
+
+        if (!m_argv_done) {
+            if (!m_parser.parseNext(m_tokenizer, m_pending)) {
+                m_argv_done = true;
+                // An exclusive switch is the last thing parsed.
+                m_done = m_parser.m_exclusive_seen;
+            }
+        } else {
+            m_parser.finishParse(m_pending);
+            m_done = true;
+        }
+    }
+
+    p_result = std::move(m_pending[m_pending_pos++]);
+    return true;
+}
+
+} // namespace AbeArgs
@@ -0,0 +1,64 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Project includes
+#include "Parser.h"
+#include "Tokenizer.h"
+
+// Standard includes
+#include <string>
+#include <utility>
+
+namespace AbeArgs {
+
+/// @brief Parses a command line one argument at a time.
+///
+/// Tokens are only split off the command line as next() needs them, so a
+/// caller that stops early (or hits an exclusive switch, which ends the
+/// stream) never pays for the rest of the line. Once the command line is
+/// used up, the values from the environment and config files follow.
+/// The parser's error(), getDiagnostics() and isMissingRequiredArgs()
+/// describe the stream so far. Use one stream at a time per parser.
+class ArgumentStream
+{
+  public:
+    ArgumentStream(Parser& p_parser, int p_argc, char* p_argv[]);
+    ArgumentStream(Parser& p_parser, std::string p_argv);
+    ~ArgumentStream() = default;
+
+    // The tokenizer views into m_argv, so the stream stays where it is.
+    ArgumentStream(const ArgumentStream&) = delete;
+    ArgumentStream& operator=(const ArgumentStream&) = delete;
+
+    bool next(std::pair<int, VarValue_t>& p_result);
+
+  private:
+    Parser& m_parser;
+    std::string m_argv;
+    Tokenizer m_tokenizer;
+
+    /// @brief Results parsed but not yet returned by next().
+    ParsedArguments_t m_pending;
+    size_t m_pending_pos = 0;
+
+    bool m_argv_done = false;
+    bool m_done = false;
+};
+
+} // namespace AbeArgs
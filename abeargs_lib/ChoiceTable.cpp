@@ -0,0 +1,132 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "ChoiceTable.h"
+
+// Project includes
+#include "Util.h"
+
+// Standard includes
+#include <algorithm>
+#include <numeric>
+
+namespace AbeArgs {
+
+ChoiceTable::ChoiceTable(const std::vector<Choice_t>& p_choices, bool p_ignore_case)
+  : m_ignore_case(p_ignore_case)
+{
+    std::vector<std::string> keys;
+    keys.reserve(p_choices.size());
+    for (const auto& [word, value] : p_choices) {
+        keys.push_back(word);
+        if (m_ignore_case)
+            Util::foldCase(keys.back(), keys.back().data());
+    }
+
+    // The first of two equal words is kept. Sorting the words once finds
+    // the repeats without comparing every pair.
+    std::vector<size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&keys](size_t p_a, size_t p_b) { return keys[p_a] < keys[p_b]; });
+    std::vector<bool> repeated(keys.size(), false);
+    for (size_t k = 1; k < order.size(); ++k)
+        repeated[order[k]] = (keys[order[k]] == keys[order[k - 1]]);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (repeated[i])
+            continue;
+
+        const std::string& word = p_choices[i].first;
+        m_words.push_back(std::move(keys[i]));
+        m_values.push_back(p_choices[i].second);
+
+        if (!m_names.empty())
+            m_names += ", ";
+        m_name_spans.emplace_back(static_cast<uint32_t>(m_names.size()), static_cast<uint32_t>(word.size()));
+        m_names += word;
+    }
+
+    // At least twice as many slots as words keeps the seed search short.
+    size_t num_slots = 1;
+    while (num_slots < m_words.size() * 2)
+        num_slots <<= 1;
+
+    for (;;) {
+        m_slots.assign(num_slots, 0);
+        for (uint64_t seed = 1; seed <= 4096; ++seed)
+            if (tryBuild(seed))
+                return;
+
+        num_slots <<= 1;
+    }
+}
+
+// FNV-1a of the word, folded to lower case when ignoring case. A word is
+// folded a chunk at a time and the chunks' hashes are chained, so a lookup
+// doesn't allocate.
+uint64_t
+ChoiceTable::hashWord(std::string_view p_word, uint64_t p_seed) const
+{
+    // The hash of nothing is the FNV offset basis.
+    uint64_t h = Util::hash({}) ^ p_seed;
+    if (!m_ignore_case)
+        return Util::hash(p_word, h);
+
+    char folded[64];
+    for (size_t i = 0; i < p_word.size(); i += sizeof(folded)) {
+        const std::string_view chunk = p_word.substr(i, sizeof(folded));
+        Util::foldCase(chunk, folded);
+        h = Util::hash({ folded, chunk.size() }, h);
+    }
+    return h;
+}
+
+bool
+ChoiceTable::equalsWord(std::string_view p_word, const std::string& p_choice) const
+{
+    return m_ignore_case ? Util::equalsFolded(p_choice, p_word) : (p_word == p_choice);
+}
+
+bool
+ChoiceTable::tryBuild(uint64_t p_seed)
+{
+    std::fill(m_slots.begin(), m_slots.end(), 0);
+    const uint64_t mask = m_slots.size() - 1;
+
+    for (size_t i = 0, n = m_words.size(); i < n; ++i) {
+        uint32_t& slot = m_slots[hashWord(m_words[i], p_seed) & mask];
+        if (slot != 0)
+            return false;
+        slot = static_cast<uint32_t>(i + 1);
+    }
+
+    m_seed = p_seed;
+    return true;
+}
+
+bool
+ChoiceTable::find(std::string_view p_word, int& p_value) const
+{
+    const uint32_t slot = m_slots[hashWord(p_word, m_seed) & (m_slots.size() - 1)];
+    if (slot == 0 || !equalsWord(p_word, m_words[slot - 1]))
+        return false;
+
+    p_value = m_values[slot - 1];
+    return true;
+}
+
+} // namespace AbeArgs
@@ -0,0 +1,78 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Standard includes
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace AbeArgs {
+
+typedef std::pair<std::string, int> Choice_t;
+
+/// @brief The allowed words of a CHOICE_TYPE argument and the value of each.
+///
+/// A seed is searched for when the table is built so that every word hashes
+/// to its own slot (a perfect hash). A lookup is then one hash of the token
+/// and one compare against the word in its slot.
+class ChoiceTable
+{
+  public:
+    ChoiceTable(const std::vector<Choice_t>& p_choices, bool p_ignore_case);
+    ~ChoiceTable() = default;
+
+    bool find(std::string_view p_word, int& p_value) const;
+
+    bool ignoresCase() const { return m_ignore_case; }
+    size_t size() const { return m_words.size(); }
+
+    /// @brief The words in the order they were given ("fast, safe, audit").
+    const std::string& getNames() const { return m_names; }
+
+    /// @brief A word as it was given (duplicates left out) and its value.
+    std::string_view getWord(size_t p_index) const
+    {
+        return std::string_view(m_names).substr(m_name_spans[p_index].first, m_name_spans[p_index].second);
+    }
+    int getValue(size_t p_index) const { return m_values[p_index]; }
+
+  private:
+    uint64_t hashWord(std::string_view p_word, uint64_t p_seed) const;
+    bool equalsWord(std::string_view p_word, const std::string& p_choice) const;
+    bool tryBuild(uint64_t p_seed);
+
+  private:
+    bool m_ignore_case = false;
+
+    /// @brief The words (folded to lower case when ignoring case) and their values.
+    std::vector<std::string> m_words;
+    std::vector<int> m_values;
+
+    /// @brief Word index + 1 by hash slot (0 is empty). Its size is a power of two.
+    std::vector<uint32_t> m_slots;
+    uint64_t m_seed = 0;
+
+    std::string m_names;
+    /// @brief Where each word is in m_names (offset, length).
+    std::vector<std::pair<uint32_t, uint32_t>> m_name_spans;
+};
+
+} // namespace AbeArgs
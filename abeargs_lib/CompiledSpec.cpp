@@ -0,0 +1,734 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "CompiledSpec.h"
+
+// Project includes
+#include "FlagStyle.h"
+#include "Parser.h"
+#include "Util.h"
+
+// Standard includes
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace AbeArgs {
+
+namespace {
+
+const char SPEC_MAGIC[8] = { 'A', 'B', 'E', 'S', 'P', 'E', 'C', '\0' };
+const uint32_t EMPTY_SLOT = 0;
+const uint8_t NO_DEFAULT = 0xff;
+
+/// @brief A string in the blob's string pool.
+struct SpecStr
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SpecHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t num_args;
+    /// @brief specKey() of the argument table: a hash of the records, choices,
+    ///        intervals and strings, leaving out the indexes and masks built from them.
+    uint64_t spec_key;
+    /// @brief FNV-1a hash of everything after the header.
+    uint64_t content_hash;
+    uint32_t total_size;
+    uint32_t args_offset;
+    /// @brief Hash index of flag text to (argument index + 1), a power of two in size.
+    uint32_t flag_index_offset;
+    uint32_t flag_index_size;
+    /// @brief Hash index of argument ID to (argument index + 1), a power of two in size.
+    uint32_t id_index_offset;
+    uint32_t id_index_size;
+    /// @brief The required, environment and exclusive switch masks, mask_words each.
+    uint32_t masks_offset;
+    uint32_t mask_words;
+    /// @brief The SpecChoice records of every argument, each argument's together.
+    uint32_t choices_offset;
+    uint32_t num_choices;
+    /// @brief The SpecInterval records of every argument, each argument's together.
+    uint32_t intervals_offset;
+    uint32_t num_intervals;
+    uint32_t pool_offset;
+    uint32_t pool_size;
+};
+
+struct SpecArg
+{
+    int32_t id;
+    uint8_t arg_class;
+    uint8_t value_type;
+    uint8_t flag_type;
+    /// @brief The VarValue_t index of the default value, or NO_DEFAULT.
+    uint8_t default_index;
+    uint32_t num_params;
+    SpecStr short_name;
+    SpecStr long_name;
+    SpecStr description;
+    SpecStr env_var;
+    SpecStr default_str;
+    /// @brief The bool, int, float or double default value.
+    uint64_t default_bits;
+    uint8_t duplicate_policy;
+    /// @brief SpecOption bits.
+    uint8_t options;
+    uint16_t unused;
+    /// @brief The argument's range of the choices and intervals.
+    uint32_t first_choice;
+    uint32_t num_choices;
+    uint32_t first_interval;
+    uint32_t num_intervals;
+    uint64_t min_length;
+    uint64_t max_length;
+};
+
+/// @brief A word of a CHOICE_TYPE argument as it was given.
+struct SpecChoice
+{
+    SpecStr word;
+    int32_t value;
+    uint32_t unused;
+};
+
+struct SpecInterval
+{
+    double low;
+    double high;
+    uint8_t low_open;
+    uint8_t high_open;
+    uint8_t unused[6];
+};
+
+enum SpecOption : uint8_t
+{
+    COUNTABLE_OPTION = 1 << 0,
+    HAS_CHOICES_OPTION = 1 << 1,
+    CHOICES_IGNORE_CASE_OPTION = 1 << 2,
+    HAS_LENGTH_LIMITS_OPTION = 1 << 3,
+    SORTED_LIST_OPTION = 1 << 4,
+    UNIQUE_LIST_OPTION = 1 << 5,
+};
+
+enum SpecMask : uint32_t
+{
+    REQUIRED_MASK = 0,
+    ENV_MASK,
+    X_SWITCH_MASK,
+    NUM_MASKS,
+};
+
+size_t
+align8(size_t p_size)
+{
+    return (p_size + 7) & ~size_t(7);
+}
+
+uint32_t
+indexSizeFor(size_t p_num_keys)
+{
+    // Keep the load factor at or below one half.
+    uint32_t size = 8;
+    while (size < p_num_keys * 2)
+        size <<= 1;
+    return size;
+}
+
+uint64_t
+hashID(int p_arg_ID)
+{
+    uint64_t h = static_cast<uint32_t>(p_arg_ID);
+    h *= 0x9e3779b97f4a7c15ull;
+    return h ^ (h >> 29);
+}
+
+const SpecHeader*
+header(const char* p_data)
+{
+    return reinterpret_cast<const SpecHeader*>(p_data);
+}
+
+const SpecArg*
+args(const char* p_data)
+{
+    return reinterpret_cast<const SpecArg*>(p_data + header(p_data)->args_offset);
+}
+
+const SpecChoice*
+choices(const char* p_data)
+{
+    return reinterpret_cast<const SpecChoice*>(p_data + header(p_data)->choices_offset);
+}
+
+const SpecInterval*
+intervals(const char* p_data)
+{
+    return reinterpret_cast<const SpecInterval*>(p_data + header(p_data)->intervals_offset);
+}
+
+// A string outside of the pool (a damaged record) reads as empty instead of
+// past the blob.
+std::string_view
+str(const char* p_data, SpecStr p_str)
+{
+    const SpecHeader* hdr = header(p_data);
+    if (p_str.offset > hdr->pool_size || p_str.length > hdr->pool_size - p_str.offset)
+        return {};
+    return { p_data + hdr->pool_offset + p_str.offset, p_str.length };
+}
+
+bool
+testMask(const char* p_data, SpecMask p_mask, size_t p_index)
+{
+    const SpecHeader* hdr = header(p_data);
+    const uint64_t* masks = reinterpret_cast<const uint64_t*>(p_data + hdr->masks_offset);
+    const uint64_t word = masks[p_mask * hdr->mask_words + p_index / 64];
+    return (word >> (p_index % 64)) & 1;
+}
+
+// Whether the flag text is the short or long flag of the argument record.
+bool
+recordMatchesFlag(const char* p_data, const SpecArg& p_arg, std::string_view p_flag)
+{
+    const std::string_view short_chars = shortFlagChars(static_cast<ArgumentType>(p_arg.flag_type));
+    const std::string_view long_chars = longFlagChars(static_cast<ArgumentType>(p_arg.flag_type));
+    const std::string_view short_name = str(p_data, p_arg.short_name);
+    const std::string_view long_name = str(p_data, p_arg.long_name);
+
+    const bool matches_short = (p_flag.size() == short_chars.size() + short_name.size()) &&
+                               (p_flag.substr(0, short_chars.size()) == short_chars) &&
+                               (p_flag.substr(short_chars.size()) == short_name);
+    const bool matches_long = (p_flag.size() == long_chars.size() + long_name.size()) &&
+                              (p_flag.substr(0, long_chars.size()) == long_chars) &&
+                              (p_flag.substr(long_chars.size()) == long_name);
+    return matches_short || matches_long;
+}
+
+// Write to the side and rename, so readers never map a partial file.
+bool
+writeBlob(const std::string& p_blob, const std::string& p_file_path)
+{
+    const std::string temp_path = p_file_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+        file.write(p_blob.data(), static_cast<std::streamsize>(p_blob.size()));
+        if (!file)
+            return false;
+    }
+
+    std::remove(p_file_path.c_str());
+    return (std::rename(temp_path.c_str(), p_file_path.c_str()) == 0);
+}
+
+} // namespace
+
+std::string
+CompiledSpec::serialize(const Parser& p_parser, std::vector<Diagnostic>* p_diagnostics)
+{
+    const ArgumentList_t& arg_list = p_parser.getArguments();
+    const size_t num_args = arg_list.size();
+
+    bool compilable = true;
+    for (const Argument& arg : arg_list) {
+        if (!arg.isBound() && (arg.getValidation() == nullptr || !arg.getValidation()->hasPredicates()))
+            continue;
+        compilable = false;
+        if (p_diagnostics != nullptr) {
+            const bool has_long_name = arg.getLongFlagName() != DEFAULT_LONG_FLAG_NAME;
+            p_diagnostics->push_back(
+              { UNCOMPILABLE_ARGUMENT, arg.getID(), has_long_name ? arg.getLongFlagName() : arg.getShortFlagName() });
+        }
+    }
+    if (!compilable)
+        return {};
+
+    std::string pool;
+    auto addString = [&pool](std::string_view p_value) {
+        const SpecStr result{ static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(p_value.size()) };
+        pool += p_value;
+        return result;
+    };
+
+    const uint32_t mask_words = static_cast<uint32_t>((num_args + 63) / 64);
+    std::vector<uint64_t> masks(NUM_MASKS * mask_words, 0);
+    std::vector<SpecArg> records(num_args);
+    std::vector<SpecChoice> choice_records;
+    std::vector<SpecInterval> interval_records;
+    std::vector<std::string> flags;
+    std::vector<uint32_t> flag_owners;
+
+    for (size_t i = 0; i < num_args; ++i) {
+        const Argument& arg = arg_list[i];
+        SpecArg& record = records[i];
+        memset(&record, 0, sizeof(record));
+
+        record.id = arg.getID();
+        record.arg_class = static_cast<uint8_t>(arg.getClass());
+        record.value_type = static_cast<uint8_t>(arg.getValueType());
+        record.flag_type = static_cast<uint8_t>(arg.getFlagType());
+        record.num_params = static_cast<uint32_t>(arg.getNumParams());
+        record.short_name = addString(arg.getShortFlagName());
+        record.long_name = addString(arg.getLongFlagName());
+        record.description = addString(arg.getDescription());
+        record.env_var = addString(arg.getEnvVar());
+        record.default_index = NO_DEFAULT;
+
+        if (arg.hasDefaultValue()) {
+            const VarValue_t value = arg.getDefaultValue();
+            record.default_index = static_cast<uint8_t>(value.index());
+            if (const bool* b = std::get_if<bool>(&value))
+                record.default_bits = *b ? 1 : 0;
+            else if (const int* n = std::get_if<int>(&value))
+                record.default_bits = static_cast<uint32_t>(*n);
+            else if (const float* f = std::get_if<float>(&value))
+                memcpy(&record.default_bits, f, sizeof(*f));
+            else if (const double* d = std::get_if<double>(&value))
+                memcpy(&record.default_bits, d, sizeof(*d));
+            else if (const std::string* s = std::get_if<std::string>(&value))
+                record.default_str = addString(*s);
+            else
+                // A list is stored as its text.
+                record.default_str = addString(valueToString(value));
+        }
+
+        record.duplicate_policy = static_cast<uint8_t>(arg.getDuplicatePolicy());
+        record.options = (arg.isCountable() ? COUNTABLE_OPTION : 0) | (arg.isSortedList() ? SORTED_LIST_OPTION : 0) |
+                         (arg.isUniqueList() ? UNIQUE_LIST_OPTION : 0);
+
+        if (const ChoiceTable* choice_table = arg.getChoices()) {
+            record.options |= HAS_CHOICES_OPTION | (choice_table->ignoresCase() ? CHOICES_IGNORE_CASE_OPTION : 0);
+            record.first_choice = static_cast<uint32_t>(choice_records.size());
+            record.num_choices = static_cast<uint32_t>(choice_table->size());
+            for (size_t c = 0; c < choice_table->size(); ++c)
+                choice_records.push_back({ addString(choice_table->getWord(c)), choice_table->getValue(c), 0 });
+        }
+
+        if (const Validation* validation = arg.getValidation()) {
+            record.first_interval = static_cast<uint32_t>(interval_records.size());
+            record.num_intervals = static_cast<uint32_t>(validation->getIntervals().size());
+            for (const Interval& interval : validation->getIntervals())
+                interval_records.push_back({ interval.low, interval.high, interval.low_open, interval.high_open, {} });
+
+            if (validation->hasLengthLimits()) {
+                record.options |= HAS_LENGTH_LIMITS_OPTION;
+                record.min_length = validation->getMinLength();
+                record.max_length = validation->getMaxLength();
+            }
+        }
+
+        if (arg.isRequired())
+            masks[REQUIRED_MASK * mask_words + i / 64] |= (1ull << (i % 64));
+        if (arg.hasEnvVar())
+            masks[ENV_MASK * mask_words + i / 64] |= (1ull << (i % 64));
+        if (arg.isXSwitch())
+            masks[X_SWITCH_MASK * mask_words + i / 64] |= (1ull << (i % 64));
+
+        // The default names signify an empty flag and are never matched.
+        if (arg.getShortFlagName() != DEFAULT_SHORT_FLAG_NAME) {
+            flags.push_back(arg.getShortFlag());
+            flag_owners.push_back(static_cast<uint32_t>(i));
+        }
+        if (arg.getLongFlagName() != DEFAULT_LONG_FLAG_NAME) {
+            flags.push_back(arg.getLongFlag());
+            flag_owners.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    // Open addressing with linear probing. The first argument to claim a
+    // flag keeps it, the same as the parser's front to back search.
+    const uint32_t flag_index_size = indexSizeFor(flags.size());
+    std::vector<uint32_t> flag_index(flag_index_size, EMPTY_SLOT);
+    for (size_t f = 0; f < flags.size(); ++f) {
+        for (uint64_t slot = Util::hash(flags[f]);; ++slot) {
+            uint32_t& entry = flag_index[slot & (flag_index_size - 1)];
+            if (entry == EMPTY_SLOT) {
+                entry = flag_owners[f] + 1;
+                break;
+            }
+            const Argument& owner = arg_list[entry - 1];
+            if (owner.getShortFlag() == flags[f] || owner.getLongFlag() == flags[f])
+                break;
+        }
+    }
+
+    const uint32_t id_index_size = indexSizeFor(num_args);
+    std::vector<uint32_t> id_index(id_index_size, EMPTY_SLOT);
+    for (size_t i = 0; i < num_args; ++i) {
+        for (uint64_t slot = hashID(records[i].id);; ++slot) {
+            uint32_t& entry = id_index[slot & (id_index_size - 1)];
+            if (entry == EMPTY_SLOT) {
+                entry = static_cast<uint32_t>(i + 1);
+                break;
+            }
+            if (records[entry - 1].id == records[i].id)
+                break;
+        }
+    }
+
+    SpecHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, SPEC_MAGIC, sizeof(SPEC_MAGIC));
+    hdr.version = VERSION;
+    hdr.num_args = static_cast<uint32_t>(num_args);
+    hdr.args_offset = static_cast<uint32_t>(align8(sizeof(SpecHeader)));
+    hdr.flag_index_offset = static_cast<uint32_t>(align8(hdr.args_offset + num_args * sizeof(SpecArg)));
+    hdr.flag_index_size = flag_index_size;
+    hdr.id_index_offset = static_cast<uint32_t>(align8(hdr.flag_index_offset + flag_index_size * sizeof(uint32_t)));
+    hdr.id_index_size = id_index_size;
+    hdr.masks_offset = static_cast<uint32_t>(align8(hdr.id_index_offset + id_index_size * sizeof(uint32_t)));
+    hdr.mask_words = mask_words;
+    hdr.choices_offset = static_cast<uint32_t>(hdr.masks_offset + masks.size() * sizeof(uint64_t));
+    hdr.num_choices = static_cast<uint32_t>(choice_records.size());
+    hdr.intervals_offset = static_cast<uint32_t>(hdr.choices_offset + choice_records.size() * sizeof(SpecChoice));
+    hdr.num_intervals = static_cast<uint32_t>(interval_records.size());
+    hdr.pool_offset = static_cast<uint32_t>(hdr.intervals_offset + interval_records.size() * sizeof(SpecInterval));
+    hdr.pool_size = static_cast<uint32_t>(pool.size());
+    hdr.total_size = static_cast<uint32_t>(hdr.pool_offset + pool.size());
+
+    std::string blob(hdr.total_size, '\0');
+    memcpy(&blob[hdr.args_offset], records.data(), records.size() * sizeof(SpecArg));
+    memcpy(&blob[hdr.flag_index_offset], flag_index.data(), flag_index.size() * sizeof(uint32_t));
+    memcpy(&blob[hdr.id_index_offset], id_index.data(), id_index.size() * sizeof(uint32_t));
+    memcpy(&blob[hdr.masks_offset], masks.data(), masks.size() * sizeof(uint64_t));
+    memcpy(&blob[hdr.choices_offset], choice_records.data(), choice_records.size() * sizeof(SpecChoice));
+    memcpy(&blob[hdr.intervals_offset], interval_records.data(), interval_records.size() * sizeof(SpecInterval));
+    memcpy(&blob[hdr.pool_offset], pool.data(), pool.size());
+
+    const std::string_view body(blob);
+    const uint64_t args_hash = Util::hash(body.substr(hdr.args_offset, hdr.flag_index_offset - hdr.args_offset));
+    hdr.spec_key = Util::hash(body.substr(hdr.choices_offset), args_hash);
+    hdr.content_hash = Util::hash(body.substr(sizeof(SpecHeader)));
+    memcpy(&blob[0], &hdr, sizeof(hdr));
+
+    return blob;
+}
+
+uint64_t
+CompiledSpec::specKey(const Parser& p_parser)
+{
+    const std::string blob = serialize(p_parser);
+    return blob.empty() ? 0 : header(blob.data())->spec_key;
+}
+
+bool
+CompiledSpec::write(const Parser& p_parser, const std::string& p_file_path, std::vector<Diagnostic>* p_diagnostics)
+{
+    const std::string blob = serialize(p_parser, p_diagnostics);
+    return !blob.empty() && writeBlob(blob, p_file_path);
+}
+
+bool
+CompiledSpec::open(const std::string& p_file_path, uint64_t p_spec_key)
+{
+    close();
+
+    if (!m_file.open(p_file_path))
+        return false;
+
+    if (!validate(m_file.view()) || header(m_file.data())->spec_key != p_spec_key) {
+        m_file.close();
+        return false;
+    }
+
+    m_data = m_file.data();
+    return true;
+}
+
+bool
+CompiledSpec::openOrBuild(const std::string& p_file_path,
+                          uint64_t p_spec_key,
+                          const std::function<void(Parser&)>& p_build)
+{
+    m_diagnostics.clear();
+    m_diagnostic_text.clear();
+
+    // The header says which argument table the cache holds. The content hash
+    // isn't checked here (that's verify()), so this costs the same for ten or
+    // ten thousand arguments.
+    if (open(p_file_path, p_spec_key)) {
+        m_was_rebuilt = false;
+        return true;
+    }
+
+    // The cache is missing or holds another table: build the parser the slow way.
+    Parser parser;
+    p_build(parser);
+    std::string blob = serialize(parser, &m_diagnostics);
+
+    // A key that isn't the table's wouldn't change when the table does, so a
+    // cache written with it could go stale. It's refused, and the diagnostic
+    // has the table's key.
+    const uint64_t built_key = blob.empty() ? p_spec_key : header(blob.data())->spec_key;
+    char key_text[24] = {};
+    if (built_key != p_spec_key) {
+        snprintf(key_text, sizeof(key_text), "0x%016llx", static_cast<unsigned long long>(built_key));
+        m_diagnostics.push_back({ STALE_SPEC_KEY, NO_ARG, key_text });
+        blob.clear();
+    }
+
+    // Point the diagnostics at a copy of their text before the parser goes.
+    for (const Diagnostic& diagnostic : m_diagnostics)
+        m_diagnostic_text += diagnostic.token;
+    size_t text_offset = 0;
+    for (Diagnostic& diagnostic : m_diagnostics) {
+        diagnostic.token = std::string_view(m_diagnostic_text).substr(text_offset, diagnostic.token.size());
+        text_offset += diagnostic.token.size();
+    }
+
+    // A cache that can't be written only costs the next run its startup.
+    if (!blob.empty())
+        writeBlob(blob, p_file_path);
+
+    const bool result = assign(std::move(blob));
+    m_was_rebuilt = true;
+    return result;
+}
+
+bool
+CompiledSpec::assign(std::string p_blob)
+{
+    close();
+
+    m_blob = std::move(p_blob);
+    if (!validate(m_blob)) {
+        m_blob.clear();
+        return false;
+    }
+
+    m_data = m_blob.data();
+    return true;
+}
+
+void
+CompiledSpec::close()
+{
+    m_file.close();
+    m_blob.clear();
+    m_data = nullptr;
+}
+
+// Check the header and that every section is where serialize() puts it. This
+// doesn't read the sections, so it costs the same for any number of arguments:
+// a record, index entry or string is checked when it's read, and the content
+// hash by verify().
+bool
+CompiledSpec::validate(std::string_view p_blob)
+{
+    if (p_blob.size() < sizeof(SpecHeader) || reinterpret_cast<uintptr_t>(p_blob.data()) % 8 != 0)
+        return false;
+
+    const SpecHeader* hdr = header(p_blob.data());
+    if (memcmp(hdr->magic, SPEC_MAGIC, sizeof(SPEC_MAGIC)) != 0)
+        return false;
+    if (hdr->version != VERSION)
+        // Written by another library version.
+        return false;
+    if (hdr->total_size != p_blob.size() || size_t(hdr->pool_offset) + hdr->pool_size != hdr->total_size)
+        // Truncated or padded.
+        return false;
+
+    // The sections follow each other in order. Sizes are computed in size_t,
+    // so a huge count can't wrap around to a small offset.
+    auto isPowerOfTwo = [](uint32_t p_size) { return p_size != 0 && (p_size & (p_size - 1)) == 0; };
+    if (!isPowerOfTwo(hdr->flag_index_size) || !isPowerOfTwo(hdr->id_index_size) ||
+        hdr->mask_words != (size_t(hdr->num_args) + 63) / 64)
+        return false;
+    if (hdr->args_offset != align8(sizeof(SpecHeader)) ||
+        hdr->flag_index_offset != align8(hdr->args_offset + size_t(hdr->num_args) * sizeof(SpecArg)) ||
+        hdr->id_index_offset != align8(hdr->flag_index_offset + size_t(hdr->flag_index_size) * sizeof(uint32_t)) ||
+        hdr->masks_offset != align8(hdr->id_index_offset + size_t(hdr->id_index_size) * sizeof(uint32_t)) ||
+        hdr->choices_offset != hdr->masks_offset + size_t(NUM_MASKS) * hdr->mask_words * sizeof(uint64_t) ||
+        hdr->intervals_offset != hdr->choices_offset + size_t(hdr->num_choices) * sizeof(SpecChoice) ||
+        hdr->pool_offset != hdr->intervals_offset + size_t(hdr->num_intervals) * sizeof(SpecInterval))
+        return false;
+
+    return true;
+}
+
+bool
+CompiledSpec::verify() const
+{
+    if (!isOpen())
+        return false;
+
+    const SpecHeader* hdr = header(m_data);
+    const std::string_view body(m_data + sizeof(SpecHeader), hdr->total_size - sizeof(SpecHeader));
+    return (Util::hash(body) == hdr->content_hash);
+}
+
+size_t
+CompiledSpec::size() const
+{
+    return isOpen() ? header(m_data)->num_args : 0;
+}
+
+uint64_t
+CompiledSpec::getSpecKey() const
+{
+    return isOpen() ? header(m_data)->spec_key : 0;
+}
+
+uint64_t
+CompiledSpec::getContentHash() const
+{
+    return isOpen() ? header(m_data)->content_hash : 0;
+}
+
+int
+CompiledSpec::findFlag(std::string_view p_flag) const
+{
+    if (!isOpen())
+        return -1;
+
+    const SpecHeader* hdr = header(m_data);
+    const uint32_t* index = reinterpret_cast<const uint32_t*>(m_data + hdr->flag_index_offset);
+    const uint32_t mask = hdr->flag_index_size - 1;
+    uint64_t slot = Util::hash(p_flag);
+    for (uint32_t probe = 0; probe < hdr->flag_index_size; ++probe, ++slot) {
+        const uint32_t entry = index[slot & mask];
+        if (entry == EMPTY_SLOT || entry > hdr->num_args)
+            return -1;
+        if (recordMatchesFlag(m_data, args(m_data)[entry - 1], p_flag))
+            return static_cast<int>(entry - 1);
+    }
+    return -1;
+}
+
+int
+CompiledSpec::findID(int p_arg_ID) const
+{
+    if (!isOpen())
+        return -1;
+
+    const SpecHeader* hdr = header(m_data);
+    const uint32_t* index = reinterpret_cast<const uint32_t*>(m_data + hdr->id_index_offset);
+    const uint32_t mask = hdr->id_index_size - 1;
+    uint64_t slot = hashID(p_arg_ID);
+    for (uint32_t probe = 0; probe < hdr->id_index_size; ++probe, ++slot) {
+        const uint32_t entry = index[slot & mask];
+        if (entry == EMPTY_SLOT || entry > hdr->num_args)
+            return -1;
+        if (args(m_data)[entry - 1].id == p_arg_ID)
+            return static_cast<int>(entry - 1);
+    }
+    return -1;
+}
+
+bool
+CompiledSpec::isRequired(size_t p_index) const
+{
+    return testMask(m_data, REQUIRED_MASK, p_index);
+}
+
+bool
+CompiledSpec::hasEnvVar(size_t p_index) const
+{
+    return testMask(m_data, ENV_MASK, p_index);
+}
+
+bool
+CompiledSpec::isXSwitch(size_t p_index) const
+{
+    return testMask(m_data, X_SWITCH_MASK, p_index);
+}
+
+Argument
+CompiledSpec::getArgument(size_t p_index) const
+{
+    const SpecHeader* hdr = header(m_data);
+    const SpecArg& record = args(m_data)[p_index];
+
+    Argument arg{ static_cast<ArgumentType>(record.arg_class),
+                  record.id,
+                  std::string(str(m_data, record.short_name)),
+                  std::string(str(m_data, record.long_name)),
+                  std::string(str(m_data, record.description)),
+                  static_cast<ArgumentType>(record.value_type),
+                  record.num_params };
+    arg.setFlagType(static_cast<ArgumentType>(record.flag_type));
+
+    if (record.env_var.length > 0)
+        arg.setEnvVar(std::string(str(m_data, record.env_var)));
+
+    arg.setDuplicatePolicy(static_cast<ArgumentType>(record.duplicate_policy));
+    arg.setCountable((record.options & COUNTABLE_OPTION) != 0);
+    arg.setListOrder((record.options & SORTED_LIST_OPTION) != 0, (record.options & UNIQUE_LIST_OPTION) != 0);
+
+    // A range outside of its section (a damaged record) reads as empty.
+    if ((record.options & HAS_CHOICES_OPTION) && size_t(record.first_choice) + record.num_choices <= hdr->num_choices) {
+        std::vector<Choice_t> choice_list;
+        choice_list.reserve(record.num_choices);
+        for (uint32_t c = 0; c < record.num_choices; ++c) {
+            const SpecChoice& choice = choices(m_data)[record.first_choice + c];
+            choice_list.emplace_back(std::string(str(m_data, choice.word)), choice.value);
+        }
+        arg.setChoices(choice_list, (record.options & CHOICES_IGNORE_CASE_OPTION) != 0);
+    }
+
+    const bool intervals_fit = size_t(record.first_interval) + record.num_intervals <= hdr->num_intervals;
+    for (uint32_t i = 0; intervals_fit && i < record.num_intervals; ++i) {
+        const SpecInterval& interval = intervals(m_data)[record.first_interval + i];
+        arg.addInterval({ interval.low, interval.high, interval.low_open != 0, interval.high_open != 0 });
+    }
+
+    if (record.options & HAS_LENGTH_LIMITS_OPTION)
+        arg.setLengthLimits(static_cast<size_t>(record.min_length), static_cast<size_t>(record.max_length));
+
+    switch (record.default_index) {
+        case 0:
+            arg.setDefaultValue(record.default_bits != 0);
+            break;
+        case 1:
+            arg.setDefaultValue(static_cast<int>(static_cast<uint32_t>(record.default_bits)));
+            break;
+        case 2: {
+            float value;
+            memcpy(&value, &record.default_bits, sizeof(value));
+            arg.setDefaultValue(value);
+            break;
+        }
+        case 3: {
+            double value;
+            memcpy(&value, &record.default_bits, sizeof(value));
+            arg.setDefaultValue(value);
+            break;
+        }
+        case 4:
+            arg.setDefaultValue(std::string(str(m_data, record.default_str)));
+            break;
+        case 5: {
+            IntList_t list;
+            if (parseIntegerList(str(m_data, record.default_str), list))
+                arg.setDefaultValue(list);
+            break;
+        }
+        default:
+            break;
+    }
+
+    return arg;
+}
+
+} // namespace AbeArgs
@@ -0,0 +1,117 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Project includes
+#include "Argument.h"
+#include "Diagnostic.h"
+#include "MappedFile.h"
+
+// Standard includes
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AbeArgs {
+
+class Parser;
+
+/// @brief A parser's argument table compiled into one flat, versioned blob.
+///
+/// The blob holds the argument records with their choices and intervals, a
+/// string pool, a hash index of the flags and IDs, and bit masks of the
+/// required, environment-bound and exclusive arguments. It is built once with
+/// serialize() and opened by mapping the file, which checks the header and
+/// section layout without reading the sections; a record is checked when it's
+/// read. A parser using the spec (Parser::setSpec) creates an Argument only
+/// for the flags that are used.
+///
+/// The spec key is a hash of the argument table (specKey()), so a cache holds
+/// the table its key names. A program keeps its table's key as a constant and
+/// opens the cache with it; openOrBuild() refuses a key that isn't the key of
+/// the table it builds, so a table changed without its key fails the first
+/// time the cache is built instead of loading a stale spec.
+class CompiledSpec
+{
+  public:
+    static const uint32_t VERSION = 2;
+
+  public:
+    CompiledSpec() = default;
+    ~CompiledSpec() = default;
+
+    CompiledSpec(const CompiledSpec&) = delete;
+    CompiledSpec& operator=(const CompiledSpec&) = delete;
+
+    /// @brief Compile p_parser's arguments. A binding or predicate is code and can't
+    ///        be stored, so each argument with one is reported in p_diagnostics
+    ///        (UNCOMPILABLE_ARGUMENT, viewing its flag name) and the blob is empty.
+    static std::string serialize(const Parser& p_parser, std::vector<Diagnostic>* p_diagnostics = nullptr);
+    static bool write(const Parser& p_parser,
+                      const std::string& p_file_path,
+                      std::vector<Diagnostic>* p_diagnostics = nullptr);
+    /// @brief The key of p_parser's argument table, or 0 if it can't be compiled.
+    static uint64_t specKey(const Parser& p_parser);
+
+    bool open(const std::string& p_file_path, uint64_t p_spec_key);
+    /// @brief Open the cache of the table with key p_spec_key, or build the table
+    ///        with p_build and write the cache. Fails with STALE_SPEC_KEY in
+    ///        getDiagnostics() if the built table's key isn't p_spec_key.
+    bool openOrBuild(const std::string& p_file_path,
+                     uint64_t p_spec_key,
+                     const std::function<void(Parser&)>& p_build);
+    bool assign(std::string p_blob);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    bool wasRebuilt() const { return m_was_rebuilt; }
+    bool verify() const;
+
+    /// @brief Why the last openOrBuild() couldn't compile the parser it built or use its key.
+    const std::vector<Diagnostic>& getDiagnostics() const { return m_diagnostics; }
+
+    size_t size() const;
+    uint64_t getSpecKey() const;
+    uint64_t getContentHash() const;
+
+    int findFlag(std::string_view p_flag) const;
+    int findID(int p_arg_ID) const;
+
+    bool isRequired(size_t p_index) const;
+    bool hasEnvVar(size_t p_index) const;
+    bool isXSwitch(size_t p_index) const;
+
+    Argument getArgument(size_t p_index) const;
+
+  private:
+    bool validate(std::string_view p_blob);
+
+  private:
+    MappedFile m_file;
+    std::string m_blob = {};
+    const char* m_data = nullptr;
+    bool m_was_rebuilt = false;
+
+    std::vector<Diagnostic> m_diagnostics;
+    /// @brief The text m_diagnostics view, since the parser they came from is gone.
+    std::string m_diagnostic_text;
+};
+
+} // namespace AbeArgs
@@ -18,19 +18,22 @@
 #pragma once
 
 // Standard includes
-#include <string>
+#include <string_view>
 
 namespace AbeArgs {
 
-static const int DEFAULT_NUM_FLAG_PARAMS = 0;
+// Constant expressions: no copies per translation unit and nothing to
+// initialize when the program starts.
 
-static const std::string DEFAULT_STR = "default_str";
-static const std::string DEFAULT_SHORT_DASH_CHARS = "-";
-static const std::string DEFAULT_LONG_DASH_CHARS = "--";
-static const std::string DEFAULT_SHORT_SLASH_CHARS = "/";
-static const std::string DEFAULT_LONG_SLASH_CHARS = "/";
-static const std::string DEFAULT_FLAG_DESC = "default_flag_desc";
-static const std::string DEFAULT_LONG_FLAG_NAME = "default_long_flag";
-static const std::string DEFAULT_SHORT_FLAG_NAME = "default_short_flag";
+inline constexpr int DEFAULT_NUM_FLAG_PARAMS = 0;
+
+inline constexpr std::string_view DEFAULT_STR = "default_str";
+inline constexpr std::string_view DEFAULT_SHORT_DASH_CHARS = "-";
+inline constexpr std::string_view DEFAULT_LONG_DASH_CHARS = "--";
+inline constexpr std::string_view DEFAULT_SHORT_SLASH_CHARS = "/";
+inline constexpr std::string_view DEFAULT_LONG_SLASH_CHARS = "/";
+inline constexpr std::string_view DEFAULT_FLAG_DESC = "default_flag_desc";
+inline constexpr std::string_view DEFAULT_LONG_FLAG_NAME = "default_long_flag";
+inline constexpr std::string_view DEFAULT_SHORT_FLAG_NAME = "default_short_flag";
 
 } // namespace AbeArgs
@@ -0,0 +1,110 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "Diagnostic.h"
+
+namespace AbeArgs {
+
+std::string
+Diagnostic::toString() const
+{
+    std::string result;
+    switch (code) {
+        case NO_ERRORS:
+            return result;
+        case UNRECOGNIZED_OPTION:
+            result = "error: Unrecognized command-line option: ";
+            break;
+        case INVALID_BOOLEAN:
+            result = "error: Invalid boolean: ";
+            break;
+        case INVALID_INTEGER:
+            result = "error: Invalid integer: ";
+            break;
+        case INVALID_FLOAT:
+            result = "error: Invalid float: ";
+            break;
+        case INVALID_DOUBLE:
+            result = "error: Invalid double: ";
+            break;
+        case INVALID_VALUE:
+            result = "error: Invalid value: ";
+            break;
+        case FILE_NOT_FOUND:
+            result = "error: File not found: ";
+            break;
+        case WRONG_PARAM_COUNT:
+            result = "error: Expected " + std::to_string(expected) + " params: ";
+            break;
+        case UNRECOGNIZED_CONFIG_KEY:
+            result = "error: Unrecognized config key: ";
+            break;
+        case DUPLICATE_OPTION:
+            result = "error: Duplicate command-line option: ";
+            break;
+        case INVALID_CHOICE:
+            result = "error: Invalid choice: ";
+            break;
+        case OUT_OF_RANGE:
+            result = "error: Value out of range: ";
+            break;
+        case INVALID_LENGTH:
+            result = "error: Invalid length: ";
+            break;
+        case FAILED_CHECK:
+            result = "error: Value failed a check: ";
+            break;
+        case DUPLICATE_KEY:
+            result = "error: Duplicate key: ";
+            break;
+        case CAPACITY_EXCEEDED:
+            result = "error: Capacity exceeded: ";
+            break;
+        case UNCOMPILABLE_ARGUMENT:
+            result = "error: Can't compile an argument with a binding or predicate: ";
+            break;
+        case STALE_SPEC_KEY:
+            result = "error: The spec key isn't the argument table's, which is: ";
+            break;
+    }
+
+    result += token;
+
+    if (!suggestion.empty()) {
+        result += " (did you mean ";
+        result += suggestion;
+        result += "?)";
+    }
+
+    if (!allowed.empty()) {
+        result += (code == INVALID_CHOICE) ? " (expected one of: " : " (expected ";
+        result += allowed;
+        result += ")";
+    }
+
+    if (!source.empty()) {
+        result += " (";
+        result += source;
+        if (position > 0)
+            result += ":" + std::to_string(position);
+        result += ")";
+    }
+
+    return result;
+}
+
+} // namespace AbeArgs
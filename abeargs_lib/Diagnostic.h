@@ -0,0 +1,95 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Standard includes
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace AbeArgs {
+
+/// @brief What went wrong while parsing.
+enum ErrorCode : int
+{
+    NO_ERRORS = 0,
+    /// @brief A token isn't a registered flag.
+    UNRECOGNIZED_OPTION,
+    INVALID_BOOLEAN,
+    INVALID_INTEGER,
+    INVALID_FLOAT,
+    INVALID_DOUBLE,
+    /// @brief A value that isn't valid for the argument's value type.
+    INVALID_VALUE,
+    FILE_NOT_FOUND,
+    /// @brief A list value with the wrong number of params.
+    WRONG_PARAM_COUNT,
+    /// @brief A config file key isn't a registered long flag name.
+    UNRECOGNIZED_CONFIG_KEY,
+    /// @brief A flag given again when its duplicate policy is DUPLICATE_ERROR.
+    DUPLICATE_OPTION,
+    /// @brief A word that isn't one of a CHOICE_TYPE argument's choices.
+    INVALID_CHOICE,
+    /// @brief A number outside of the argument's allowed intervals.
+    OUT_OF_RANGE,
+    /// @brief A string shorter or longer than the argument's length limits.
+    INVALID_LENGTH,
+    /// @brief A value that one of the argument's predicates rejected.
+    FAILED_CHECK,
+    /// @brief A MAP_TYPE key given again when its duplicate policy is DUPLICATE_ERROR.
+    DUPLICATE_KEY,
+    /// @brief A FixedParser ran out of room for the arguments, tokens, results or values.
+    CAPACITY_EXCEEDED,
+    /// @brief An argument with a binding or predicate, which a CompiledSpec can't store.
+    UNCOMPILABLE_ARGUMENT,
+    /// @brief A CompiledSpec key that isn't CompiledSpec::specKey() of its argument table.
+    STALE_SPEC_KEY,
+};
+
+/// @brief One parse error: a code and the span of input it refers to.
+///        The text is only built when toString() is called.
+struct Diagnostic
+{
+    ErrorCode code = NO_ERRORS;
+    int arg_ID = 0;
+
+    /// @brief The offending token. It views the parser's tokens, the environment
+    ///        block or the loaded config file, and is valid until the next parse.
+    std::string_view token = {};
+
+    /// @brief The token's position in argv, or its line in a config file.
+    size_t position = 0;
+
+    /// @brief The expected param count (WRONG_PARAM_COUNT only).
+    size_t expected = 0;
+
+    /// @brief Where the token came from when not from argv (a config file or environment variable).
+    std::string_view source = {};
+
+    /// @brief What the value should have been (the choices, the intervals or the length limits).
+    std::string_view allowed = {};
+
+    /// @brief The closest registered flag to an unrecognized one (UNRECOGNIZED_OPTION only).
+    ///        It's a copy, because the suggestion pool is rebuilt when a spec's
+    ///        argument is created later in the same parse.
+    std::string suggestion = {};
+
+    std::string toString() const;
+};
+
+} // namespace AbeArgs
@@ -0,0 +1,469 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "FixedParser.h"
+
+// Project includes
+#include "FlagStyle.h"
+#include "Util.h"
+
+// Standard includes
+#include <algorithm>
+#include <sys/stat.h>
+
+namespace AbeArgs {
+
+namespace {
+
+bool
+fileExists(const char* p_file_path)
+{
+    struct stat info;
+    return stat(p_file_path, &info) == 0;
+}
+
+} // namespace
+
+FixedParserBase::FixedParserBase(std::span<FixedArgument> p_args,
+                                 std::span<bool> p_given,
+                                 std::span<std::string_view> p_tokens,
+                                 std::span<FixedResult_t> p_results,
+                                 std::span<char> p_values)
+  : m_args(p_args)
+  , m_given(p_given)
+  , m_tokens(p_tokens)
+  , m_results(p_results)
+  , m_values(p_values)
+{
+}
+
+FixedArgument*
+FixedParserBase::addArgument(const FixedArgument& p_arg)
+{
+    if (m_num_args == m_args.size()) {
+        m_args_overflowed = true;
+        return nullptr;
+    }
+
+    FixedArgument& arg = m_args[m_num_args++];
+    arg = p_arg;
+
+    // The same defaults as Argument::initValueType().
+    if (arg.value_type == DEFAULT_VALUE_TYPE) {
+        if (arg.arg_class == X_SWITCH)
+            arg.value_type = NO_VALUE_TYPE;
+        else if (arg.arg_class == SWITCH)
+            arg.value_type = BOOLEAN_TYPE;
+        else if (arg.arg_class == OPTIONAL || arg.arg_class == REQUIRED)
+            arg.value_type = STRING_TYPE;
+    }
+
+    if ((arg.arg_class == OPTIONAL || arg.arg_class == REQUIRED) && arg.num_params == DEFAULT_NUM_FLAG_PARAMS)
+        arg.num_params = 1;
+
+    return &arg;
+}
+
+std::span<const FixedResult_t>
+FixedParserBase::exec(std::string_view p_argv)
+{
+    m_tokenizer.reset(p_argv);
+    return execTokens();
+}
+
+// Read argv in place, starting after the executable name (argv[0]).
+std::span<const FixedResult_t>
+FixedParserBase::exec(int p_argc, char* p_argv[])
+{
+    m_tokenizer.reset(p_argc, p_argv);
+    return execTokens();
+}
+
+std::span<const FixedResult_t>
+FixedParserBase::execTokens()
+{
+    beginParse();
+    while (parseNext()) {
+    }
+
+    if (m_num_results == 0)
+        // The default NO_ARG option (the results have room for it).
+        m_results[m_num_results++] = { NO_ARG, DEFAULT_STR };
+
+    return getResults();
+}
+
+void
+FixedParserBase::beginParse()
+{
+    m_diagnostic = {};
+    std::fill(m_given.begin(), m_given.end(), false);
+    m_num_tokens = 0;
+    m_num_results = 0;
+    m_value_size = 0;
+    m_flag_position = 0;
+    m_exclusive_seen = false;
+    m_passthrough_args = {};
+
+    if (m_args_overflowed)
+        setError({ CAPACITY_EXCEEDED, NO_ARG });
+}
+
+// Parse one flag and its params. Returns false when there is nothing more
+// to parse.
+bool
+FixedParserBase::parseNext()
+{
+    if (m_exclusive_seen || error())
+        return false;
+
+    std::string_view token;
+    size_t i = 0;
+    if (!pullToken(token, i))
+        return false;
+
+    m_flag_position = i;
+    if (token == "--") {
+        // The end of the options. Argv is the caller's, so it can be kept.
+        if (m_tokenizer.isWholeArg())
+            m_passthrough_args = m_tokenizer.restOfArgv(false);
+        return false;
+    }
+
+    const FixedArgument* arg = findFlag(token);
+    if (arg == nullptr) {
+        // A single dash followed by more than one character (-abc).
+        if (token.size() > 2 && token[0] == '-' && token[1] != '-')
+            return parseShortCluster(token, i);
+
+        setError({ UNRECOGNIZED_OPTION, NO_ARG, token, i });
+        return true;
+    }
+
+    return parseArgument(*arg, token, i, {});
+}
+
+// The same steps as Parser::parseArgument().
+bool
+FixedParserBase::parseArgument(const FixedArgument& p_arg, std::string_view p_token, size_t p_position, std::string_view p_attached)
+{
+    if (p_arg.arg_class == X_SWITCH) {
+        // Only handle the first exclusive switch, then stop.
+        m_num_results = 0;
+        addResult(p_arg, true);
+        m_exclusive_seen = true;
+        return false;
+    }
+
+    const bool is_switch = (p_arg.arg_class == SWITCH);
+    const size_t num_params = p_arg.num_params;
+    if (is_switch && num_params == 0) {
+        // The presence of the switch makes it true.
+        addResult(p_arg, true);
+        return true;
+    } else if (num_params == 0 || (is_switch && num_params > 1)) {
+        return true;
+    }
+
+    std::string_view param = p_attached;
+    size_t next_i = p_position;
+    if (param.empty() && !pullToken(param, next_i))
+        // A flag without its params at the end of the line is ignored.
+        return false;
+
+    if (is_switch) {
+        // The value of the switch is defined by the next parameter.
+        bool value = false;
+        if (Util::toBoolean(param, value))
+            addResult(p_arg, value);
+        else
+            setError({ INVALID_BOOLEAN, p_arg.id, param, next_i });
+        return true;
+    }
+
+    if (p_arg.arg_class != OPTIONAL && p_arg.arg_class != REQUIRED)
+        return true;
+
+    const size_t arg_index = static_cast<size_t>(&p_arg - m_args.data());
+    if (num_params == 1) {
+        FixedValue_t value;
+        const ErrorCode code = convertValue(p_arg, param, value);
+        if (code != NO_ERRORS)
+            setError({ code, p_arg.id, param, next_i });
+        else if (addResult(p_arg, value))
+            m_given[arg_index] = true;
+        return true;
+    }
+
+    // Pull all of the params before checking any of them.
+    const size_t rest_i = m_num_tokens;
+    for (size_t k = 1; k < num_params; ++k) {
+        std::string_view unused;
+        size_t unused_position = 0;
+        if (!pullToken(unused, unused_position)) {
+            // Not enough tokens left for all of the params.
+            setError({ WRONG_PARAM_COUNT, p_arg.id, p_token, p_position, num_params });
+            return false;
+        }
+    }
+
+    // Pack them into a comma separated string.
+    const size_t joined_start = m_value_size;
+    for (size_t k = 0; k < num_params; ++k) {
+        if ((k != 0 && !appendValue(",")) || !appendValue(k == 0 ? param : m_tokens[rest_i + k - 1])) {
+            setError({ CAPACITY_EXCEEDED, p_arg.id, p_token, p_position });
+            return true;
+        }
+    }
+    if (storeValue({}) == nullptr) {
+        setError({ CAPACITY_EXCEEDED, p_arg.id, p_token, p_position });
+        return true;
+    }
+    const std::string_view joined(m_values.data() + joined_start, m_value_size - joined_start - 1);
+
+    // Verify the type of each one.
+    for (size_t k = 0; k < num_params; ++k) {
+        const std::string_view value = (k == 0) ? param : m_tokens[rest_i + k - 1];
+        const size_t mark = m_value_size;
+        FixedValue_t unused;
+        const ErrorCode code = convertValue(p_arg, value, unused);
+        m_value_size = mark;
+        if (code != NO_ERRORS) {
+            setError({ code, p_arg.id, value, (k == 0) ? next_i : rest_i + k - 1 });
+            return true;
+        }
+    }
+
+    if (addResult(p_arg, joined))
+        m_given[arg_index] = true;
+    return true;
+}
+
+// Expand -abc into -a -b -c. A flag that takes a value ends the cluster and
+// the rest of the token is its value (-ofile), or the next token if nothing
+// is left.
+bool
+FixedParserBase::parseShortCluster(std::string_view p_token, size_t p_position)
+{
+    char flag[2] = { p_token[0], 0 };
+
+    // Check every flag of the cluster before using any of them.
+    for (size_t c = 1, n = p_token.size(); c < n; ++c) {
+        flag[1] = p_token[c];
+        const FixedArgument* arg = findFlag({ flag, 2 });
+        if (arg == nullptr) {
+            setError({ UNRECOGNIZED_OPTION, NO_ARG, p_token, p_position });
+            return true;
+        }
+        if (arg->arg_class == X_SWITCH || arg->num_params > 0)
+            break;
+    }
+
+    for (size_t c = 1, n = p_token.size(); c < n; ++c) {
+        flag[1] = p_token[c];
+        const FixedArgument& arg = *findFlag({ flag, 2 });
+        if (arg.arg_class == X_SWITCH || arg.num_params > 0)
+            return parseArgument(arg, p_token, p_position, p_token.substr(c + 1));
+
+        parseArgument(arg, p_token, p_position, {});
+    }
+
+    return true;
+}
+
+// The arguments are few, so they're searched in order. The default flag
+// names mark an argument without that flag, so they never match.
+const FixedArgument*
+FixedParserBase::findFlag(std::string_view p_token) const
+{
+    for (size_t i = 0; i < m_num_args; ++i) {
+        const FixedArgument& arg = m_args[i];
+        FlagName flag;
+        if (arg.arg_class == NO_ARG || !stripFlagChars(arg.flag_type, p_token, flag))
+            continue;
+
+        if (flag.is_short && flag.name == arg.short_name && arg.short_name != DEFAULT_SHORT_FLAG_NAME)
+            return &arg;
+        if (flag.is_long && flag.name == arg.long_name && arg.long_name != DEFAULT_LONG_FLAG_NAME)
+            return &arg;
+    }
+
+    return nullptr;
+}
+
+const FixedValue_t*
+FixedParserBase::findValue(int p_arg_ID) const
+{
+    for (size_t i = m_num_results; i > 0; --i)
+        if (m_results[i - 1].first == p_arg_ID)
+            return &m_results[i - 1].second;
+
+    for (size_t i = 0; i < m_num_args; ++i)
+        if (m_args[i].id == p_arg_ID && m_args[i].has_default)
+            return &m_args[i].default_value;
+
+    return nullptr;
+}
+
+bool
+FixedParserBase::isMissingRequiredArgs() const
+{
+    for (size_t i = 0; i < m_num_args; ++i)
+        if (m_args[i].arg_class == REQUIRED && !m_given[i])
+            return true;
+    return false;
+}
+
+// With LAST_WINS every occurrence is listed.
+bool
+FixedParserBase::addResult(const FixedArgument& p_arg, const FixedValue_t& p_value)
+{
+    if (m_num_results == m_results.size()) {
+        setError({ CAPACITY_EXCEEDED, p_arg.id, m_tokens[m_flag_position], m_flag_position });
+        return false;
+    }
+
+    m_results[m_num_results++] = { p_arg.id, p_value };
+    return true;
+}
+
+// Convert one param into the argument's value type. The param is copied into
+// the value bytes, which gives the conversions their NUL; only a string keeps
+// its copy.
+ErrorCode
+FixedParserBase::convertValue(const FixedArgument& p_arg, std::string_view p_param, FixedValue_t& p_value)
+{
+    const size_t mark = m_value_size;
+    const char* text = storeValue(p_param);
+    if (text == nullptr)
+        return CAPACITY_EXCEEDED;
+
+    ErrorCode code = NO_ERRORS;
+    switch (p_arg.value_type) {
+        case STRING_TYPE:
+            p_value = std::string_view(text, p_param.size());
+            return NO_ERRORS;
+        case FILE_TYPE:
+            if (!fileExists(text))
+                code = FILE_NOT_FOUND;
+            else {
+                p_value = std::string_view(text, p_param.size());
+                return NO_ERRORS;
+            }
+            break;
+        case BOOLEAN_TYPE: {
+            bool value = false;
+            if (Util::toBoolean(p_param, value))
+                p_value = value;
+            else
+                code = INVALID_BOOLEAN;
+            break;
+        }
+        case INTEGER_TYPE: {
+            int value = 0;
+            if (Util::toInteger(text, value))
+                p_value = value;
+            else
+                code = INVALID_INTEGER;
+            break;
+        }
+        case FLOAT_TYPE: {
+            float value = 0.f;
+            if (Util::toReal(text, value))
+                p_value = value;
+            else
+                code = INVALID_FLOAT;
+            break;
+        }
+        case DOUBLE_TYPE: {
+            double value = 0;
+            if (Util::toReal(text, value))
+                p_value = value;
+            else
+                code = INVALID_DOUBLE;
+            break;
+        }
+        default:
+            code = INVALID_VALUE;
+            break;
+    }
+
+    m_value_size = mark;
+    return code;
+}
+
+// Copy a value into the value bytes with a NUL after it.
+// @return The copy, or nullptr if there isn't room
+const char*
+FixedParserBase::storeValue(std::string_view p_value)
+{
+    const size_t start = m_value_size;
+    if (!appendValue(p_value) || m_value_size == m_values.size()) {
+        m_value_size = start;
+        return nullptr;
+    }
+
+    m_values[m_value_size++] = 0;
+    return m_values.data() + start;
+}
+
+bool
+FixedParserBase::appendValue(std::string_view p_value)
+{
+    if (m_values.size() - m_value_size < p_value.size())
+        return false;
+
+    std::copy(p_value.begin(), p_value.end(), m_values.begin() + m_value_size);
+    m_value_size += p_value.size();
+    return true;
+}
+
+// A parse stops at its first error, so that's the one that's kept.
+void
+FixedParserBase::setError(const Diagnostic& p_diagnostic)
+{
+    if (!error())
+        m_diagnostic = p_diagnostic;
+}
+
+// Store the next token so the params of a flag can be pulled before any of
+// them is checked.
+bool
+FixedParserBase::pullToken(std::string_view& p_token, size_t& p_position)
+{
+    // Joined blocks of pairs go after the values stored so far.
+    m_tokenizer.setJoinBuffer(m_values.subspan(m_value_size));
+    std::string_view token;
+    if (!m_tokenizer.next(token)) {
+        if (m_tokenizer.joinOverflowed())
+            setError({ CAPACITY_EXCEEDED, NO_ARG, token, m_num_tokens });
+        return false;
+    }
+    m_value_size += m_tokenizer.getJoinedSize();
+
+    if (m_num_tokens == m_tokens.size()) {
+        setError({ CAPACITY_EXCEEDED, NO_ARG, token, m_num_tokens });
+        return false;
+    }
+
+    p_position = m_num_tokens;
+    m_tokens[m_num_tokens++] = token;
+    p_token = token;
+    return true;
+}
+
+} // namespace AbeArgs
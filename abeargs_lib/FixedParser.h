@@ -0,0 +1,215 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Project includes
+#include "Argument.h"
+#include "Defaults.h"
+#include "Diagnostic.h"
+#include "Tokenizer.h"
+
+// Standard includes
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace AbeArgs {
+
+/// @brief A value of a FixedParser. Strings view the parser's value bytes.
+typedef std::variant<bool, int, float, double, std::string_view> FixedValue_t;
+typedef std::pair<int, FixedValue_t> FixedResult_t;
+
+/// @brief An argument of a FixedParser. The fields are in the order of the
+///        Argument constructor, so { OPTIONAL, ID, "o", "out", "Output file" }
+///        reads the same for both. The names are views: they have to outlive
+///        the parser (string literals do).
+struct FixedArgument
+{
+    ArgumentType arg_class = NO_ARG;
+    int id = 0;
+    std::string_view short_name = DEFAULT_SHORT_FLAG_NAME;
+    std::string_view long_name = DEFAULT_LONG_FLAG_NAME;
+    std::string_view description = DEFAULT_FLAG_DESC;
+    ArgumentType value_type = DEFAULT_VALUE_TYPE;
+    size_t num_params = DEFAULT_NUM_FLAG_PARAMS;
+    ArgumentType flag_type = DASH_FLAG;
+    FixedValue_t default_value = false;
+    bool has_default = false;
+};
+
+/// @brief The parsing of a FixedParser, over tables it doesn't own.
+///
+/// A parse reads the command line the way Parser::exec() does and gives the
+/// same results and errors, but it never allocates and never throws: each
+/// table has a fixed size, and running out of room is a CAPACITY_EXCEEDED
+/// error. Switches, exclusive switches, optional and required arguments of
+/// the string, file, boolean, integer, float and double types, dash and slash
+/// flags and short flag clusters are supported. The rest of Parser (config
+/// files, the environment, specs, bindings, positional, list, choice and map
+/// arguments, validation and the duplicate policies other than LAST_WINS)
+/// isn't.
+class FixedParserBase
+{
+  public:
+    // The tables belong to the FixedParser the base is part of.
+    FixedParserBase(const FixedParserBase&) = delete;
+    FixedParserBase& operator=(const FixedParserBase&) = delete;
+
+    /// @brief Add an argument, the way Parser::addArgument() sets up its value type and params.
+    /// @return The added argument, or nullptr if the table is full (the next exec fails with CAPACITY_EXCEEDED)
+    FixedArgument* addArgument(const FixedArgument& p_arg);
+
+    /// @brief Parse a command line. The results, and the diagnostic's token,
+    ///        are valid until the next exec and while the command line is.
+    std::span<const FixedResult_t> exec(std::string_view p_argv);
+    std::span<const FixedResult_t> exec(int p_argc, char* p_argv[]);
+
+    std::span<const FixedResult_t> getResults() const { return { m_results.data(), m_num_results }; }
+
+    bool error() const { return m_diagnostic.code != NO_ERRORS; }
+    ErrorCode getErrorCode() const { return m_diagnostic.code; }
+    /// @brief The first error of the last parse (a parse stops at it).
+    const Diagnostic& getDiagnostic() const { return m_diagnostic; }
+
+    bool isMissingRequiredArgs() const;
+
+    /// @brief The argv elements after "--". The rest of a string command line isn't kept.
+    std::span<char* const> getPassthroughArgs() const { return m_passthrough_args; }
+
+    /// @brief The last value given for the argument, else its default, else T{}.
+    ///        Numbers are converted to T; strings are std::string_view.
+    template<class T>
+    T get(int p_arg_ID) const
+    {
+        T result{};
+        const FixedValue_t* value = findValue(p_arg_ID);
+        if (value == nullptr)
+            return result;
+
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            if (const std::string_view* str = std::get_if<std::string_view>(value))
+                result = *str;
+        } else {
+            static_assert(std::is_arithmetic_v<T>, "Read strings as std::string_view");
+            std::visit(
+              [&result](auto p_value) {
+                  if constexpr (std::is_arithmetic_v<decltype(p_value)>)
+                      result = static_cast<T>(p_value);
+              },
+              *value);
+        }
+        return result;
+    }
+
+  protected:
+    FixedParserBase(std::span<FixedArgument> p_args,
+                    std::span<bool> p_given,
+                    std::span<std::string_view> p_tokens,
+                    std::span<FixedResult_t> p_results,
+                    std::span<char> p_values);
+    ~FixedParserBase() = default;
+
+  private:
+    std::span<const FixedResult_t> execTokens();
+    void beginParse();
+    bool parseNext();
+    bool parseArgument(const FixedArgument& p_arg, std::string_view p_token, size_t p_position, std::string_view p_attached);
+    bool parseShortCluster(std::string_view p_token, size_t p_position);
+    const FixedArgument* findFlag(std::string_view p_token) const;
+    const FixedValue_t* findValue(int p_arg_ID) const;
+
+    bool addResult(const FixedArgument& p_arg, const FixedValue_t& p_value);
+    ErrorCode convertValue(const FixedArgument& p_arg, std::string_view p_param, FixedValue_t& p_value);
+    const char* storeValue(std::string_view p_value);
+    bool appendValue(std::string_view p_value);
+    void setError(const Diagnostic& p_diagnostic);
+    bool pullToken(std::string_view& p_token, size_t& p_position);
+
+  private:
+    std::span<FixedArgument> m_args;
+    /// @brief Whether each argument was given (required arguments only).
+    std::span<bool> m_given;
+    std::span<std::string_view> m_tokens;
+    std::span<FixedResult_t> m_results;
+    /// @brief String values (NUL terminated) and joined blocks of pairs.
+    std::span<char> m_values;
+
+    size_t m_num_args = 0;
+    size_t m_num_tokens = 0;
+    size_t m_num_results = 0;
+    size_t m_value_size = 0;
+    bool m_args_overflowed = false;
+
+    Diagnostic m_diagnostic = {};
+    size_t m_flag_position = 0;
+    bool m_exclusive_seen = false;
+    std::span<char* const> m_passthrough_args = {};
+
+    /// @brief Joins blocks of pairs in the value bytes.
+    Tokenizer m_tokenizer;
+};
+
+/// @brief The tables of a FixedParser. They're a base class listed before
+///        FixedParserBase so they're built before it's given them.
+template<size_t MaxArgs, size_t MaxTokens, size_t MaxValueBytes>
+struct FixedParserTables
+{
+    std::array<FixedArgument, MaxArgs> m_arg_table{};
+    std::array<bool, MaxArgs> m_given_table{};
+    std::array<std::string_view, MaxTokens> m_token_table{};
+    std::array<FixedResult_t, MaxTokens + 1> m_result_table{};
+    std::array<char, MaxValueBytes> m_value_bytes{};
+};
+
+/// @brief A parser for programs that can't use the heap: no allocations and
+///        no exceptions, with every table sized at compile time.
+///
+///     FixedParser<8, 32, 512> parser;
+///     parser.addArgument({ OPTIONAL, THREADS_ID, "t", "threads", "Threads", INTEGER_TYPE });
+///     parser.exec(argc, argv);
+///     const int threads = parser.get<int>(THREADS_ID);
+///
+/// @tparam MaxArgs The number of arguments that can be added
+/// @tparam MaxTokens The number of tokens a command line can have (the
+///         results can hold one more, for the NO_ARG default)
+/// @tparam MaxValueBytes The bytes for string values and joined blocks of
+///         pairs, each with a NUL
+template<size_t MaxArgs, size_t MaxTokens, size_t MaxValueBytes>
+class FixedParser
+  : private FixedParserTables<MaxArgs, MaxTokens, MaxValueBytes>
+  , public FixedParserBase
+{
+    typedef FixedParserTables<MaxArgs, MaxTokens, MaxValueBytes> Tables_t;
+
+  public:
+    FixedParser()
+      : FixedParserBase(Tables_t::m_arg_table,
+                        Tables_t::m_given_table,
+                        Tables_t::m_token_table,
+                        Tables_t::m_result_table,
+                        Tables_t::m_value_bytes)
+    {
+    }
+    ~FixedParser() = default;
+};
+
+} // namespace AbeArgs
@@ -0,0 +1,107 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Project includes
+#include "Argument.h"
+#include "Defaults.h"
+
+// Standard includes
+#include <string_view>
+
+namespace AbeArgs {
+
+/// @brief The characters that start a short flag of the flag type.
+constexpr std::string_view
+shortFlagChars(ArgumentType p_flag_type)
+{
+    return (p_flag_type == SLASH_FLAG) ? DEFAULT_SHORT_SLASH_CHARS : DEFAULT_SHORT_DASH_CHARS;
+}
+
+/// @brief The characters that start a long flag of the flag type.
+constexpr std::string_view
+longFlagChars(ArgumentType p_flag_type)
+{
+    return (p_flag_type == SLASH_FLAG) ? DEFAULT_LONG_SLASH_CHARS : DEFAULT_LONG_DASH_CHARS;
+}
+
+/// @brief A flag token with its prefix stripped off.
+struct FlagName
+{
+    std::string_view name = {};
+    ArgumentType flag_type = NO_ARG;
+
+    /// @brief Whether the name is a short name, a long name, or either one
+    ///        (short and long slash flags share their prefix).
+    bool is_short = false;
+    bool is_long = false;
+};
+
+/// @brief Strip the prefix of a flag type off the token.
+/// @return False if the token doesn't start with the flag type's prefix
+constexpr bool
+stripFlagChars(ArgumentType p_flag_type, std::string_view p_token, FlagName& p_flag)
+{
+    const std::string_view short_chars = shortFlagChars(p_flag_type);
+    const std::string_view long_chars = longFlagChars(p_flag_type);
+
+    const bool is_long = p_token.starts_with(long_chars);
+    // "--name" is never the short flag "-" + "-name".
+    const bool is_short = p_token.starts_with(short_chars) && !(is_long && long_chars.size() > short_chars.size());
+    if (!is_short && !is_long)
+        return false;
+
+    p_flag.name = p_token.substr(is_long ? long_chars.size() : short_chars.size());
+    p_flag.flag_type = p_flag_type;
+    p_flag.is_short = is_short;
+    p_flag.is_long = is_long;
+    return true;
+}
+
+// The flag styles a parser looks flags up with. The parser uses the narrowest
+// one that covers its arguments, and its lookups are instantiated per style so
+// the prefix checks are inlined.
+
+/// @brief POSIX style flags only (-s and --long).
+struct DashStyle
+{
+    static constexpr bool strip(std::string_view p_token, FlagName& p_flag)
+    {
+        return stripFlagChars(DASH_FLAG, p_token, p_flag);
+    }
+};
+
+/// @brief Windows style flags only (/s and /long).
+struct SlashStyle
+{
+    static constexpr bool strip(std::string_view p_token, FlagName& p_flag)
+    {
+        return stripFlagChars(SLASH_FLAG, p_token, p_flag);
+    }
+};
+
+/// @brief Dash and slash flags in the same parser.
+struct AnyStyle
+{
+    static constexpr bool strip(std::string_view p_token, FlagName& p_flag)
+    {
+        return DashStyle::strip(p_token, p_flag) || SlashStyle::strip(p_token, p_flag);
+    }
+};
+
+} // namespace AbeArgs
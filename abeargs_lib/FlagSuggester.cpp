@@ -0,0 +1,287 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+// Project includes
+#include "FlagSuggester.h"
+#include "Util.h"
+
+// Standard includes
+#include <algorithm>
+#include <bit>
+#include <numeric>
+
+namespace AbeArgs {
+
+namespace {
+
+// Patterns are matched a machine word at a time.
+constexpr size_t MAX_PATTERN_SIZE = 64;
+
+// How often the clock is read while searching.
+constexpr size_t CLOCK_INTERVAL = 32;
+
+} // namespace
+
+// Add a flag as its prefix and bare name (--, verbose). Names of a single
+// character are too short to guess at, so they're left out.
+void
+FlagSuggester::add(std::string_view p_prefix, std::string_view p_name)
+{
+    if (p_name.size() < 2 || p_name.size() > MAX_PATTERN_SIZE)
+        return;
+
+    Candidate candidate;
+    candidate.offset = static_cast<uint32_t>(m_pool.size());
+    candidate.prefix_size = static_cast<uint16_t>(p_prefix.size());
+    candidate.name_size = static_cast<uint16_t>(p_name.size());
+    candidate.bag = characterBag(p_name);
+    candidate.counts = characterCounts(p_name);
+
+    m_pool.append(p_prefix);
+    m_pool.append(p_name);
+    m_candidates.push_back(candidate);
+    m_sorted = false;
+}
+
+// Remove the flags but keep the capacity.
+void
+FlagSuggester::clear()
+{
+    m_pool.clear();
+    m_candidates.clear();
+    m_length_starts.clear();
+    m_sorted = true;
+}
+
+// Find up to p_max flags within a few edits of the bare name p_name, closest
+// first. The matches view the pool, so they're valid until it changes.
+// Returns the number of matches.
+size_t
+FlagSuggester::suggest(std::string_view p_name, Match* p_matches, size_t p_max, std::chrono::microseconds p_budget) const
+{
+    const size_t size = p_name.size();
+    if (p_max == 0 || size < 2 || size > MAX_PATTERN_SIZE || m_candidates.empty())
+        return 0;
+
+    const auto deadline = std::chrono::steady_clock::now() + p_budget;
+    sortByLength();
+
+    uint64_t peq[256];
+    buildPeq(p_name, peq);
+    Candidate query;
+    query.bag = characterBag(p_name);
+    query.counts = characterCounts(p_name);
+
+    // Allow about one edit for every three characters.
+    size_t limit = std::max<size_t>(1, size / 3);
+    size_t found = 0;
+    size_t checked = 0;
+
+    const size_t max_length = m_length_starts.size() - 2;
+    for (size_t diff = 0; diff <= limit; ++diff) {
+        for (int side = 0; side < (diff == 0 ? 1 : 2); ++side) {
+            const size_t length = (side == 0) ? size + diff : size - diff;
+            if (length < 2 || length > max_length)
+                continue;
+
+            for (uint32_t i = m_length_starts[length], end = m_length_starts[length + 1]; i < end; ++i) {
+                if (++checked % CLOCK_INTERVAL == 0 && std::chrono::steady_clock::now() > deadline)
+                    return found;
+
+                const Candidate& candidate = m_candidates[i];
+                if (missingCharacters(query, candidate) > limit)
+                    continue;
+
+                const std::string_view name(m_pool.data() + candidate.offset + candidate.prefix_size, candidate.name_size);
+                const size_t distance = bitParallelDistance(peq, size, name, limit);
+                if (distance > limit || (found == p_max && distance >= p_matches[found - 1].distance))
+                    continue;
+
+                // Keep the matches sorted, the earlier of equals first.
+                size_t at = (found < p_max) ? found++ : found - 1;
+                while (at > 0 && p_matches[at - 1].distance > distance) {
+                    p_matches[at] = p_matches[at - 1];
+                    --at;
+                }
+                p_matches[at] = { { m_pool.data() + candidate.offset, size_t(candidate.prefix_size) + candidate.name_size },
+                                  distance };
+
+                // Once full, only closer flags can get in.
+                if (found == p_max)
+                    limit = std::min(limit, p_matches[found - 1].distance);
+            }
+        }
+    }
+
+    return found;
+}
+
+// The Levenshtein distance between two strings, ignoring case.
+size_t
+FlagSuggester::distance(std::string_view p_a, std::string_view p_b)
+{
+    if (p_a.size() > p_b.size())
+        std::swap(p_a, p_b);
+    if (p_a.empty())
+        return p_b.size();
+
+    if (p_a.size() <= MAX_PATTERN_SIZE) {
+        uint64_t peq[256];
+        buildPeq(p_a, peq);
+        return bitParallelDistance(peq, p_a.size(), p_b, p_b.size());
+    }
+
+    // Too long for a word: one row of the table at a time.
+    std::vector<size_t> row(p_a.size() + 1);
+    std::iota(row.begin(), row.end(), size_t(0));
+    for (size_t j = 1; j <= p_b.size(); ++j) {
+        size_t diagonal = row[0];
+        row[0] = j;
+        for (size_t i = 1; i <= p_a.size(); ++i) {
+            const size_t above = row[i];
+            const size_t cost = (Util::foldCase(p_a[i - 1]) == Util::foldCase(p_b[j - 1])) ? 0 : 1;
+            row[i] = std::min({ above + 1, row[i - 1] + 1, diagonal + cost });
+            diagonal = above;
+        }
+    }
+    return row[p_a.size()];
+}
+
+// Group the candidates by the length of their bare names, keeping the order
+// they were added in for each length.
+void
+FlagSuggester::sortByLength() const
+{
+    if (m_sorted)
+        return;
+
+    std::stable_sort(m_candidates.begin(), m_candidates.end(), [](const Candidate& p_a, const Candidate& p_b) {
+        return p_a.name_size < p_b.name_size;
+    });
+
+    const size_t max_length = m_candidates.back().name_size;
+    m_length_starts.assign(max_length + 2, 0);
+    for (const Candidate& candidate : m_candidates)
+        ++m_length_starts[candidate.name_size + 1];
+    for (size_t length = 1; length < m_length_starts.size(); ++length)
+        m_length_starts[length] += m_length_starts[length - 1];
+
+    m_sorted = true;
+}
+
+uint64_t
+FlagSuggester::characterBag(std::string_view p_name)
+{
+    uint64_t bag = 0;
+    for (char c : p_name)
+        bag |= uint64_t(1) << (static_cast<unsigned char>(Util::foldCase(c)) % 64);
+    return bag;
+}
+
+// A saturating 4-bit count of each character modulo 16.
+uint64_t
+FlagSuggester::characterCounts(std::string_view p_name)
+{
+    uint64_t counts = 0;
+    for (char c : p_name) {
+        const unsigned shift = (static_cast<unsigned char>(Util::foldCase(c)) % 16) * 4;
+        if (((counts >> shift) & 0xf) != 0xf)
+            counts += uint64_t(1) << shift;
+    }
+    return counts;
+}
+
+// A lower bound on the edits between two names: each character one has more
+// of than the other needs its own edit. Characters that share a bit or a count
+// are taken as the same, which only lowers the bound.
+size_t
+FlagSuggester::missingCharacters(const Candidate& p_a, const Candidate& p_b)
+{
+    // The sum over the counts of max(0, x - y), eight byte-sized counts at a time.
+    auto excess = [](uint64_t p_x, uint64_t p_y) {
+        const uint64_t highs = 0x8080808080808080ull;
+        const uint64_t lows = 0x0f0f0f0f0f0f0f0full;
+        size_t sum = 0;
+        for (int half = 0; half < 2; ++half) {
+            const uint64_t x = (p_x >> (half * 4)) & lows;
+            const uint64_t y = (p_y >> (half * 4)) & lows;
+            // Per byte 0x80 + x - y; the high bit is set where x >= y.
+            const uint64_t d = (x | highs) - y;
+            const uint64_t keep = ((d & highs) >> 7) * 0xff;
+            sum += (((d & ~highs) & keep) * 0x0101010101010101ull) >> 56;
+        }
+        return sum;
+    };
+
+    const size_t a_bits = static_cast<size_t>(std::popcount(p_a.bag & ~p_b.bag));
+    const size_t b_bits = static_cast<size_t>(std::popcount(p_b.bag & ~p_a.bag));
+    return std::max({ a_bits, b_bits, excess(p_a.counts, p_b.counts), excess(p_b.counts, p_a.counts) });
+}
+
+// The match masks of the pattern: bit i of p_peq[c] is set if character i is
+// c. A letter's mask is set for both cases, so the text isn't folded.
+void
+FlagSuggester::buildPeq(std::string_view p_pattern, uint64_t* p_peq)
+{
+    std::fill(p_peq, p_peq + 256, 0);
+    for (size_t i = 0; i < p_pattern.size(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(Util::foldCase(p_pattern[i]));
+        p_peq[c] |= uint64_t(1) << i;
+        if (c >= 'a' && c <= 'z')
+            p_peq[c - 'a' + 'A'] |= uint64_t(1) << i;
+    }
+}
+
+// The edit distance between a pattern of up to 64 characters and p_text, one
+// column of the table per character. The column's vertical deltas are kept as
+// bit vectors of +1s (vp) and -1s (vn), and the score tracks its last row.
+// Anything more than p_limit is returned as p_limit + 1.
+size_t
+FlagSuggester::bitParallelDistance(const uint64_t* p_peq, size_t p_size, std::string_view p_text, size_t p_limit)
+{
+    const uint64_t last = uint64_t(1) << (p_size - 1);
+    uint64_t vp = ~uint64_t(0);
+    uint64_t vn = 0;
+    size_t score = p_size;
+
+    for (size_t j = 0, n = p_text.size(); j < n; ++j) {
+        const uint64_t eq = p_peq[static_cast<unsigned char>(p_text[j])];
+        const uint64_t xv = eq | vn;
+        const uint64_t xh = (((eq & vp) + vp) ^ vp) | eq;
+        uint64_t hp = vn | ~(xh | vp);
+        uint64_t hn = vp & xh;
+
+        if (hp & last)
+            ++score;
+        else if (hn & last)
+            --score;
+
+        // The score moves by at most one per remaining character.
+        if (score > p_limit + (n - j - 1))
+            return p_limit + 1;
+
+        // The top row of the table counts up (the text's prefix against nothing).
+        hp = (hp << 1) | 1;
+        hn <<= 1;
+        vp = hn | ~(xv | hp);
+        vn = hp & xv;
+    }
+
+    return std::min(score, p_limit + 1);
+}
+
+} // namespace AbeArgs
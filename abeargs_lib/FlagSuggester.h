@@ -0,0 +1,95 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Standard includes
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AbeArgs {
+
+/// @brief Finds the registered flags closest to a mistyped one ("did you mean").
+///
+/// The flags are kept in one string pool and grouped by the length of their
+/// bare names. A query looks at the lengths nearest its own first and drops a
+/// candidate without computing its distance if the length difference or the
+/// characters one has and the other lacks (compared as bags of characters)
+/// already cost more edits than the worst match kept. The distances are computed with Myers' bit-parallel
+/// algorithm (as given by Hyyrö), a few word operations per character. Case is
+/// ignored. A query stops when its time budget runs out and returns the best
+/// matches found so far.
+class FlagSuggester
+{
+  public:
+    static constexpr std::chrono::microseconds DEFAULT_BUDGET{ 200 };
+
+    /// @brief A suggested flag and its edit distance from the query.
+    struct Match
+    {
+        std::string_view flag;
+        size_t distance = 0;
+    };
+
+    FlagSuggester() = default;
+    ~FlagSuggester() = default;
+
+    void add(std::string_view p_prefix, std::string_view p_name);
+    void clear();
+    size_t size() const { return m_candidates.size(); }
+
+    size_t suggest(std::string_view p_name,
+                   Match* p_matches,
+                   size_t p_max,
+                   std::chrono::microseconds p_budget = DEFAULT_BUDGET) const;
+
+    static size_t distance(std::string_view p_a, std::string_view p_b);
+
+  private:
+    /// @brief A flag in the pool: the whole flag and its bare name's offset and size.
+    struct Candidate
+    {
+        uint32_t offset = 0;
+        uint16_t prefix_size = 0;
+        uint16_t name_size = 0;
+        /// @brief The bare name's characters (folded): a bit for each one modulo 64,
+        ///        and a 4-bit count of each one modulo 16.
+        uint64_t bag = 0;
+        uint64_t counts = 0;
+    };
+
+    void sortByLength() const;
+
+    static uint64_t characterBag(std::string_view p_name);
+    static uint64_t characterCounts(std::string_view p_name);
+    static size_t missingCharacters(const Candidate& p_a, const Candidate& p_b);
+    static void buildPeq(std::string_view p_pattern, uint64_t* p_peq);
+    static size_t bitParallelDistance(const uint64_t* p_peq, size_t p_size, std::string_view p_text, size_t p_limit);
+
+  private:
+    std::string m_pool;
+    mutable std::vector<Candidate> m_candidates;
+    /// @brief The first candidate of each bare name length (valid once sorted).
+    mutable std::vector<uint32_t> m_length_starts;
+    mutable bool m_sorted = true;
+};
+
+} // namespace AbeArgs
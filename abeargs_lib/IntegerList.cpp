@@ -0,0 +1,174 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "IntegerList.h"
+
+// Standard includes
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+namespace AbeArgs {
+
+namespace {
+
+/// @brief A range can't expand to more values than this.
+const int64_t s_max_range_values = int64_t(1) << 24;
+
+// Whether all 8 bytes are '0'..'9'.
+bool
+allDigits(uint64_t p_chars)
+{
+    return ((p_chars & 0xF0F0F0F0F0F0F0F0ull) |
+            (((p_chars + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+// Convert 8 digits (the first one in the lowest byte) in three multiplies.
+uint32_t
+eightDigits(uint64_t p_chars)
+{
+    p_chars = ((p_chars & 0x0F0F0F0F0F0F0F0Full) * 2561) >> 8;
+    p_chars = ((p_chars & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+    return static_cast<uint32_t>(((p_chars & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32);
+}
+
+// Parse an optionally negative number at p_pos, leaving p_pos after it.
+bool
+parseNumber(std::string_view p_text, size_t& p_pos, int64_t& p_value)
+{
+    const size_t n = p_text.size();
+    bool negative = false;
+    if (p_pos < n && p_text[p_pos] == '-') {
+        negative = true;
+        ++p_pos;
+    }
+
+    const size_t start = p_pos;
+    uint64_t value = 0;
+
+    if constexpr (std::endian::native == std::endian::little) {
+        while (p_pos + 8 <= n && value <= UINT32_MAX) {
+            uint64_t chars;
+            memcpy(&chars, p_text.data() + p_pos, sizeof(chars));
+            if (!allDigits(chars))
+                break;
+            value = value * 100000000ull + eightDigits(chars);
+            p_pos += 8;
+        }
+    }
+
+    for (; p_pos < n && value <= UINT32_MAX; ++p_pos) {
+        const unsigned digit = static_cast<unsigned>(p_text[p_pos] - '0');
+        if (digit > 9)
+            break;
+        value = value * 10 + digit;
+    }
+
+    if (p_pos == start || (p_pos < n && p_text[p_pos] >= '0' && p_text[p_pos] <= '9'))
+        // No digits, or too many of them.
+        return false;
+
+    p_value = negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    return p_value >= INT_MIN && p_value <= INT_MAX;
+}
+
+} // namespace
+
+bool
+parseIntegerList(std::string_view p_text, IntList_t& p_list)
+{
+    const size_t n = p_text.size();
+    size_t pos = 0;
+
+    while (pos < n) {
+        int64_t first = 0;
+        if (!parseNumber(p_text, pos, first))
+            return false;
+
+        int64_t last = first;
+        int64_t step = 1;
+        if (pos < n && p_text[pos] == '-') {
+            ++pos;
+            if (!parseNumber(p_text, pos, last))
+                return false;
+
+            if (pos < n && p_text[pos] == ':') {
+                ++pos;
+                if (!parseNumber(p_text, pos, step) || step <= 0)
+                    return false;
+            }
+        }
+
+        if (pos < n) {
+            if (p_text[pos] != ',' || pos + 1 == n)
+                return false;
+            ++pos;
+        }
+
+        const int64_t span = (first <= last) ? last - first : first - last;
+        if (span / step >= s_max_range_values)
+            return false;
+
+        // Expand the range straight into the list. Growing by at least double
+        // keeps a long list of single values linear.
+        const size_t count = static_cast<size_t>(span / step) + 1;
+        if (p_list.capacity() - p_list.size() < count)
+            p_list.reserve(std::max(p_list.size() + count, 2 * p_list.capacity()));
+        if (first <= last)
+            for (int64_t value = first; value <= last; value += step)
+                p_list.push_back(static_cast<int>(value));
+        else
+            for (int64_t value = first; value >= last; value -= step)
+                p_list.push_back(static_cast<int>(value));
+    }
+
+    return n > 0;
+}
+
+void
+orderIntegerList(IntList_t& p_list, bool p_sort, bool p_unique)
+{
+    if (p_sort) {
+        std::sort(p_list.begin(), p_list.end());
+        if (p_unique)
+            p_list.erase(std::unique(p_list.begin(), p_list.end()), p_list.end());
+        return;
+    }
+
+    if (!p_unique)
+        return;
+
+    // Keep the first of each value in its place: find values in a sorted
+    // copy and mark each one as it's seen.
+    IntList_t sorted = p_list;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<bool> seen(sorted.size(), false);
+
+    size_t kept = 0;
+    for (const int value : p_list) {
+        const size_t index = std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin();
+        if (seen[index])
+            continue;
+        seen[index] = true;
+        p_list[kept++] = value;
+    }
+    p_list.resize(kept);
+}
+
+} // namespace AbeArgs
@@ -0,0 +1,38 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Standard includes
+#include <string_view>
+#include <vector>
+
+namespace AbeArgs {
+
+typedef std::vector<int> IntList_t;
+
+/// @brief Decode a comma separated list of integers and ranges into p_list
+///        (appended). An item is a number (-3), a range (0-1023, both ends
+///        included, counting down if the first end is larger) or a range
+///        with a step (0-100:10). Runs of 8 digits are converted at once.
+/// @return false if an item isn't a number or a range, or a number doesn't fit an int
+bool parseIntegerList(std::string_view p_text, IntList_t& p_list);
+
+/// @brief Sort the list and/or drop repeated values (keeping the first of each).
+void orderIntegerList(IntList_t& p_list, bool p_sort, bool p_unique);
+
+} // namespace AbeArgs
@@ -0,0 +1,124 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+// Project includes
+#include "LineDispatcher.h"
+
+// Standard includes
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace AbeArgs {
+
+LineDispatcher::LineDispatcher(Parser& p_parser, LineHandler_t p_handler, size_t p_buffer_size)
+  : m_parser(p_parser)
+  , m_handler(std::move(p_handler))
+  , m_buffer(p_buffer_size > 0 ? p_buffer_size : DEFAULT_BUFFER_SIZE)
+{
+}
+
+// Read and dispatch lines until the end of the input, a read error or a handler
+// returning false. Returns true at the end of the input.
+bool
+LineDispatcher::run(int p_fd)
+{
+    m_begin = m_scanned = m_end = 0;
+    m_line_number = 0;
+    m_read_error = false;
+
+    while (true) {
+        if (m_end == m_buffer.size()) {
+            if (m_begin > 0) {
+                // Move the unfinished line to the front to make room.
+                memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+                m_scanned -= m_begin;
+                m_end -= m_begin;
+                m_begin = 0;
+            }
+            else {
+                m_buffer.resize(m_buffer.size() * 2);
+            }
+        }
+
+#ifdef _WIN32
+        const int bytes = _read(p_fd, m_buffer.data() + m_end, static_cast<unsigned>(m_buffer.size() - m_end));
+#else
+        const ssize_t bytes = read(p_fd, m_buffer.data() + m_end, m_buffer.size() - m_end);
+#endif
+        if (bytes < 0) {
+            if (errno == EINTR)
+                continue;
+            m_read_error = true;
+            return false;
+        }
+
+        if (bytes == 0) {
+            // The last line may not end with a newline.
+            if (m_begin < m_end && !dispatch(m_buffer.data() + m_begin, m_buffer.data() + m_end))
+                return false;
+            m_begin = m_scanned = m_end;
+            return true;
+        }
+
+        m_end += static_cast<size_t>(bytes);
+        if (!dispatchLines())
+            return false;
+    }
+}
+
+// Dispatch every complete line in the buffer.
+bool
+LineDispatcher::dispatchLines()
+{
+    const char* data = m_buffer.data();
+    while (m_scanned < m_end) {
+        const void* newline = memchr(data + m_scanned, '\n', m_end - m_scanned);
+        if (newline == nullptr) {
+            m_scanned = m_end;
+            break;
+        }
+
+        const size_t line_end = static_cast<size_t>(static_cast<const char*>(newline) - data);
+        const size_t line_begin = m_begin;
+        m_begin = m_scanned = line_end + 1;
+        if (!dispatch(data + line_begin, data + line_end))
+            return false;
+    }
+    return true;
+}
+
+bool
+LineDispatcher::dispatch(const char* p_begin, const char* p_end)
+{
+    ++m_line_number;
+    if (p_begin < p_end && p_end[-1] == '\r')
+        --p_end;
+    if (p_begin == p_end)
+        return true;
+
+    const std::string_view line(p_begin, static_cast<size_t>(p_end - p_begin));
+    m_parser.exec(line, m_context);
+    return m_handler(m_parser, line);
+}
+
+} // namespace AbeArgs
@@ -0,0 +1,84 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Project includes
+#include "ParseContext.h"
+#include "Parser.h"
+
+// Standard includes
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace AbeArgs {
+
+/// @brief Called with the parser after each line is parsed, and the line itself.
+///        Check p_parser.error() and read the values with p_parser.getResults().
+///        The line is only valid during the call. Return false to stop reading.
+typedef std::function<bool(Parser& p_parser, std::string_view p_line)> LineHandler_t;
+
+/// @brief Reads command lines from a file descriptor (stdin, a pipe, a socket)
+///        and parses each one as it's completed.
+///
+/// Reads land straight in the buffer and lines are parsed where they are. A
+/// line split across reads is finished by the next read, right after it; only
+/// when the buffer's end is reached is the unfinished line moved back to the
+/// front. The buffer grows if a single line doesn't fit. A "\r\n" ending is
+/// accepted and blank lines are skipped.
+class LineDispatcher
+{
+  public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    LineDispatcher(Parser& p_parser, LineHandler_t p_handler, size_t p_buffer_size = DEFAULT_BUFFER_SIZE);
+    ~LineDispatcher() = default;
+
+    LineDispatcher(const LineDispatcher&) = delete;
+    LineDispatcher& operator=(const LineDispatcher&) = delete;
+
+    bool run(int p_fd);
+
+    /// @brief The number of lines read so far (blank ones included), so the
+    ///        current line's number inside the handler.
+    size_t getLineNumber() const { return m_line_number; }
+    /// @brief Whether the last run() stopped because of a read error.
+    bool readError() const { return m_read_error; }
+
+  private:
+    bool dispatchLines();
+    bool dispatch(const char* p_begin, const char* p_end);
+
+  private:
+    Parser& m_parser;
+    LineHandler_t m_handler;
+    ParseContext m_context;
+
+    std::vector<char> m_buffer;
+    /// @brief The unparsed bytes are [m_begin, m_end), and [m_begin, m_scanned)
+    ///        is known to hold no newline.
+    size_t m_begin = 0;
+    size_t m_scanned = 0;
+    size_t m_end = 0;
+
+    size_t m_line_number = 0;
+    bool m_read_error = false;
+};
+
+} // namespace AbeArgs
@@ -0,0 +1,56 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Standard includes
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace AbeArgs {
+
+/// @brief A read-only view of a whole file.
+///        The file is memory-mapped where the platform allows it, otherwise it is read into memory.
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& p_file_path);
+    void close();
+
+    bool isOpen() const { return m_is_open; }
+    size_t size() const { return m_size; }
+    const char* data() const { return m_data; }
+    std::string_view view() const { return { m_data, m_size }; }
+
+  private:
+    bool m_is_open = false;
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+
+    /// @brief Whether m_data points at a mapping (and not at m_buffer).
+    bool m_is_mapped = false;
+    std::string m_buffer = {};
+};
+
+} // namespace AbeArgs
@@ -0,0 +1,103 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "OptionsStore.h"
+
+// Project includes
+#include "Parser.h"
+
+// Standard includes
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace AbeArgs {
+
+OptionsSnapshot::OptionsSnapshot(const Parser& p_parser, uint64_t p_generation)
+  : m_generation(p_generation)
+{
+    const std::string blob = ResultsSnapshot::serialize(p_parser);
+    m_storage.resize((blob.size() + 7) / 8);
+    memcpy(m_storage.data(), blob.data(), blob.size());
+    m_values.open({ reinterpret_cast<const char*>(m_storage.data()), blob.size() }, ResultsSnapshot::fingerprint(p_parser));
+}
+
+OptionsStore::Reader::Reader(const OptionsStore& p_store)
+  : Reader(p_store, currentParity(p_store))
+{
+}
+
+OptionsStore::Reader::Reader(const OptionsStore& p_store, unsigned p_parity)
+  : m_store(p_store)
+  , m_parity(p_parity)
+{
+    // Count in before loading the pointer: a writer that missed the count
+    // had already published the pointer that's loaded.
+    m_store.m_readers[m_parity].count.fetch_add(1);
+    m_snapshot = m_store.m_current.load();
+}
+
+unsigned
+OptionsStore::Reader::currentParity(const OptionsStore& p_store)
+{
+    return p_store.m_parity.load() & 1;
+}
+
+OptionsStore::Reader::~Reader()
+{
+    m_store.m_readers[m_parity].count.fetch_sub(1, std::memory_order_release);
+}
+
+OptionsStore::~OptionsStore()
+{
+    delete m_current.load();
+}
+
+// Publish the values of the parser's last parse and return the IDs of the
+// options that changed since the last snapshot (all of the ones with a
+// value, the first time). Returns once the old snapshot is deleted.
+std::vector<int>
+OptionsStore::publish(const Parser& p_parser)
+{
+    std::lock_guard<std::mutex> lock(m_publish_mutex);
+
+    const OptionsSnapshot* snapshot = new OptionsSnapshot(p_parser, m_generation++);
+    const OptionsSnapshot* old = m_current.exchange(snapshot);
+    std::vector<int> changed =
+      ResultsSnapshot::changedIDs((old != nullptr) ? old->getValues() : ResultsSnapshot(), snapshot->getValues());
+
+    // Wait for both parities to drain. Any reader that holds the old snapshot
+    // counted itself in one of them before the swap; each flip sends new
+    // readers to the parity that isn't being waited on.
+    for (int flip = 0; flip < 2; ++flip) {
+        const unsigned old_parity = m_parity.fetch_xor(1) & 1;
+        while (m_readers[old_parity].count.load() != 0)
+            std::this_thread::yield();
+    }
+
+    delete old;
+    return changed;
+}
+
+uint64_t
+OptionsStore::getGeneration() const
+{
+    const Reader reader(*this);
+    return reader ? reader->getGeneration() : 0;
+}
+
+} // namespace AbeArgs
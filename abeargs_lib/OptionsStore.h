@@ -0,0 +1,126 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Project includes
+#include "ResultsSnapshot.h"
+
+// Standard includes
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace AbeArgs {
+
+class Parser;
+
+/// @brief The values of one parse, frozen. It's never changed after it's
+///        published, so readers don't need a lock.
+class OptionsSnapshot
+{
+  public:
+    OptionsSnapshot(const Parser& p_parser, uint64_t p_generation);
+    ~OptionsSnapshot() = default;
+
+    OptionsSnapshot(const OptionsSnapshot&) = delete;
+    OptionsSnapshot& operator=(const OptionsSnapshot&) = delete;
+
+    const ResultsSnapshot& getValues() const { return m_values; }
+    /// @brief How many snapshots were published before this one.
+    uint64_t getGeneration() const { return m_generation; }
+
+  private:
+    /// @brief The serialized values (8-byte aligned, as ResultsSnapshot needs).
+    std::vector<uint64_t> m_storage;
+    ResultsSnapshot m_values;
+    uint64_t m_generation = 0;
+};
+
+/// @brief Publishes the options to reader threads and swaps them on reload,
+///        read-copy-update style.
+///
+/// A reload parses with the writer's parser and publishes a new snapshot;
+/// the current one is an atomic pointer that's swapped in one store. A
+/// reader pins the snapshot with a Reader: it counts itself in the counter
+/// of the current grace period's parity and then loads the pointer, with a
+/// fixed number of atomic operations (wait-free, no lock and no retry).
+/// publish() swaps the pointer and then waits out both parities: it flips
+/// the parity and waits for the readers counted in the old one to leave,
+/// twice, and only then deletes the old snapshot. One flip isn't enough: a
+/// reader that loaded the parity before an earlier publish flipped it counts
+/// itself in the stale parity, which that single wait wouldn't drain.
+/// Publishing is serialized by a mutex that readers never touch. Keep
+/// Readers short: a reload waits for them.
+class OptionsStore
+{
+  public:
+    /// @brief Pins the current snapshot until it's destroyed.
+    class Reader
+    {
+      public:
+        explicit Reader(const OptionsStore& p_store);
+        ~Reader();
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /// @brief False before the first snapshot is published.
+        explicit operator bool() const { return m_snapshot != nullptr; }
+        const OptionsSnapshot& operator*() const { return *m_snapshot; }
+        const OptionsSnapshot* operator->() const { return m_snapshot; }
+
+      protected:
+        /// @brief Counts in the given parity, as loaded by currentParity() (the
+        ///        two steps of the constructor, so a test can stall between them).
+        Reader(const OptionsStore& p_store, unsigned p_parity);
+        static unsigned currentParity(const OptionsStore& p_store);
+
+      private:
+        const OptionsStore& m_store;
+        unsigned m_parity = 0;
+        const OptionsSnapshot* m_snapshot = nullptr;
+    };
+
+  public:
+    OptionsStore() = default;
+    ~OptionsStore();
+
+    OptionsStore(const OptionsStore&) = delete;
+    OptionsStore& operator=(const OptionsStore&) = delete;
+
+    std::vector<int> publish(const Parser& p_parser);
+    Reader read() const { return Reader(*this); }
+    uint64_t getGeneration() const;
+
+  private:
+    /// @brief A reader counter on its own cache line.
+    struct alignas(64) ReaderCount
+    {
+        std::atomic<uint64_t> count{ 0 };
+    };
+
+    std::atomic<const OptionsSnapshot*> m_current{ nullptr };
+    std::atomic<unsigned> m_parity{ 0 };
+    mutable ReaderCount m_readers[2];
+
+    std::mutex m_publish_mutex;
+    uint64_t m_generation = 0;
+};
+
+} // namespace AbeArgs
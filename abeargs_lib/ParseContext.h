@@ -0,0 +1,48 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Project includes
+#include "Tokenizer.h"
+
+namespace AbeArgs {
+
+/// @brief What one command line after another is parsed with, for a parser
+///        that's reused (see Parser::exec(std::string_view, ParseContext&)).
+///
+/// The buffers are cleared between parses, not freed. Together with the
+/// parser's own token and result storage, that means a parse of a command
+/// line no bigger than the ones before it doesn't allocate.
+class ParseContext
+{
+    friend class Parser;
+
+  public:
+    ParseContext() = default;
+    ~ParseContext() = default;
+
+    // The tokenizer views the command line being parsed.
+    ParseContext(const ParseContext&) = delete;
+    ParseContext& operator=(const ParseContext&) = delete;
+
+  private:
+    /// @brief Keeps the capacity of the buffer that blocks of pairs are joined in.
+    Tokenizer m_tokenizer;
+};
+
+} // namespace AbeArgs
@@ -20,59 +20,335 @@
 // Project includes
 #include "AbeMath.h"
 #include "Argument.h"
+#include "CompiledSpec.h"
+#include "MappedFile.h"
+#include "Results.h"
 #include "Util.h"
 #ifdef _MSC_VER
 #include "MSVC.h"
 #endif
 
 // Standard includes
-#include <iostream>
+#include <algorithm>
+#include <cstdio>
 #include <memory>
 
+#ifdef _WIN32
+#include <stdlib.h>
+#define ABEARGS_ENVIRON _environ
+#else
+extern char** environ;
+#define ABEARGS_ENVIRON environ
+#endif
+
 using namespace std;
 
 namespace AbeArgs {
 
-static Argument s_no_arg{};
+namespace {
+
+// What the lookups return when nothing matches. It's created on first use,
+// so there's nothing to initialize when the program starts.
+Argument&
+noArg()
+{
+    static Argument no_arg{};
+    return no_arg;
+}
+
+const ValueMap&
+noValueMap()
+{
+    static const ValueMap no_map{};
+    return no_map;
+}
+
+// Add a repeated flag's value to the ones before it: a list of integers to
+// the list, anything else to the comma separated text.
+void
+accumulateValue(VarValue_t& p_values, const VarValue_t& p_value)
+{
+    IntList_t* list = get_if<IntList_t>(&p_values);
+    const IntList_t* more = get_if<IntList_t>(&p_value);
+    if (list != nullptr && more != nullptr)
+        list->insert(list->end(), more->begin(), more->end());
+    else
+        p_values = valueToString(p_values) + ',' + valueToString(p_value);
+}
+
+} // namespace
 
 Argument*
 Parser::addArgument(const Argument& p_arg)
 {
+    // The argument's index is its slot in the results. The first of
+    // several arguments with the same ID is the one that's found.
+    m_id_slots.emplace(p_arg.getID(), m_args.size());
+    m_slot_values.emplace_back();
+    m_slot_sources.push_back(NO_ARG);
+    m_slot_occurrences.emplace_back();
+    m_slot_converted.emplace_back();
+    if (m_args.size() % 64 == 0)
+        m_slot_present.push_back(0);
+
+    if (p_arg.isPositional())
+        m_positionals.push_back(m_args.size());
+    else if (p_arg.isVariadic() && m_variadic == NO_SLOT)
+        m_variadic = m_args.size();
+
     m_args.push_back(std::move(p_arg));
+    indexFlagNames(m_args.size() - 1);
     if (p_arg.isRequired())
         // Arguments start out missing (they haven't been parsed yet).
         m_required_args.insert({ p_arg.getID(), true });
     return &m_args.back();
 }
 
+// Index single character short flags by their character and the other
+// names by name (folded when ignoring case). The default names mean there's
+// no flag, so they aren't indexed. The first argument with a name keeps it.
+void
+Parser::indexFlagNames(size_t p_index)
+{
+    if (m_args[p_index].isPositional() || m_args[p_index].isVariadic())
+        // Positional arguments don't have flags.
+        return;
+
+    const int index = static_cast<int>(p_index) + 1;
+    const std::string& short_name = m_args[p_index].getShortFlagName();
+    const std::string& long_name = m_args[p_index].getLongFlagName();
+
+    auto indexName = [&](const std::string& p_name, size_t p_which) {
+        std::string key = p_name;
+        if (m_ignore_flag_case)
+            Util::foldCase(key, key.data());
+        int& entry = m_flag_names[key][p_which];
+        if (entry == 0)
+            entry = index;
+    };
+
+    if (short_name.size() == 1) {
+        const char c = m_ignore_flag_case ? Util::foldCase(short_name[0]) : short_name[0];
+        int& entry = m_short_flags[static_cast<unsigned char>(c)];
+        if (entry == 0)
+            entry = index;
+    } else if (short_name != DEFAULT_SHORT_FLAG_NAME)
+        indexName(short_name, 0);
+
+    if (long_name != DEFAULT_LONG_FLAG_NAME)
+        indexName(long_name, 1);
+}
+
+// Match flags ignoring ASCII case (/VERBOSE for /verbose). The names are
+// folded into the index once, so it's rebuilt here. Flags that are looked
+// up in an attached spec still have to match exactly.
+void
+Parser::setIgnoreFlagCase(bool p_ignore_case)
+{
+    if (p_ignore_case == m_ignore_flag_case)
+        return;
+
+    m_ignore_flag_case = p_ignore_case;
+    m_short_flags.fill(0);
+    m_flag_names.clear();
+    for (size_t i = 0; i < m_args.size(); ++i)
+        indexFlagNames(i);
+}
+
 Argument&
 Parser::getArgument(int p_arg_ID)
 {
-    for (Argument& arg : m_args)
-        if (arg.getID() == p_arg_ID)
-            return arg;
+    const size_t slot = findSlot(p_arg_ID);
+    if (slot != NO_SLOT)
+        return m_args[slot];
 
-    return s_no_arg;
+    if (m_spec != nullptr) {
+        const int spec_index = m_spec->findID(p_arg_ID);
+        if (spec_index >= 0)
+            return *addArgument(m_spec->getArgument(spec_index));
+    }
+
+    return noArg();
 }
 
 const Argument&
 Parser::getArgument(int p_arg_ID) const
 {
-    for (const Argument& arg : const_cast<ArgumentList_t&>(m_args))
-        if (arg.getID() == p_arg_ID)
-            return arg;
+    const size_t slot = findSlot(p_arg_ID);
+    if (slot != NO_SLOT)
+        return m_args[slot];
 
-    return s_no_arg;
+    return noArg();
+}
+
+size_t
+Parser::findSlot(int p_arg_ID) const
+{
+    const auto found = m_id_slots.find(p_arg_ID);
+    return (found == m_id_slots.end()) ? NO_SLOT : found->second;
+}
+
+bool
+Parser::isPresent(size_t p_slot) const
+{
+    return p_slot != NO_SLOT && ((m_slot_present[p_slot / 64] >> (p_slot % 64)) & 1) != 0;
+}
+
+// The value given for the argument, else its default (if p_use_default), else nullptr.
+const VarValue_t*
+Parser::findValue(int p_arg_ID, bool p_use_default) const
+{
+    const size_t slot = findSlot(p_arg_ID);
+    if (slot == NO_SLOT)
+        return nullptr;
+
+    if (isPresent(slot))
+        return &m_slot_values[slot];
+
+    if (p_use_default && m_args[slot].hasDefaultValue())
+        return &m_args[slot].getDefaultValue();
+
+    return nullptr;
+}
+
+Results
+Parser::getResults() const
+{
+    return Results(*this);
+}
+
+// The KEY=VALUE entries of a MAP_TYPE argument from the last parse. They
+// view the parsed tokens, so they're valid until the next parse.
+const ValueMap&
+Parser::getValueMap(int p_arg_ID) const
+{
+    const auto found = m_value_maps.find(p_arg_ID);
+    return (found == m_value_maps.end()) ? noValueMap() : found->second;
 }
 
 Argument&
 Parser::getArgument(const std::string& p_flag)
 {
-    for (Argument& arg : m_args)
-        if (arg.matchesFlag(p_flag))
-            return arg;
+    Argument* arg = findFlag<AnyStyle>(p_flag);
+    return (arg != nullptr) ? *arg : noArg();
+}
+
+// Find the argument of a flag token. The style strips the prefix once, and
+// the lookups compare bare names. Arguments that haven't been created from
+// the spec yet are created here.
+template<class Style_t>
+Argument*
+Parser::findFlag(std::string_view p_token)
+{
+    FlagName flag;
+    if (!Style_t::strip(p_token, flag))
+        return nullptr;
+
+    char folded[128];
+    if (m_ignore_flag_case) {
+        char* out = folded;
+        if (flag.name.size() > sizeof(folded)) {
+            m_folded_name.resize(flag.name.size());
+            out = m_folded_name.data();
+        }
+        Util::foldCase(flag.name, out);
+        flag.name = { out, flag.name.size() };
+    }
+
+    Argument* arg = findFlagName(flag);
+    if (arg == nullptr && m_spec != nullptr) {
+        const int spec_index = m_spec->findFlag(p_token);
+        if (spec_index >= 0)
+            arg = addArgument(m_spec->getArgument(spec_index));
+    }
+
+    return arg;
+}
+
+// Look up a bare flag name. The indexes hold the first argument with each
+// name; if that one has the other flag type, the rest are searched.
+Argument*
+Parser::findFlagName(const FlagName& p_flag)
+{
+    int short_index = 0;
+    int long_index = 0;
+    if (p_flag.is_short && p_flag.name.size() == 1)
+        short_index = m_short_flags[static_cast<unsigned char>(p_flag.name[0])];
+
+    if (p_flag.is_long || (p_flag.is_short && p_flag.name.size() != 1)) {
+        const auto found = m_flag_names.find(p_flag.name);
+        if (found != m_flag_names.end()) {
+            if (p_flag.is_short && p_flag.name.size() != 1)
+                short_index = found->second[0];
+            if (p_flag.is_long)
+                long_index = found->second[1];
+        }
+    }
+
+    if (short_index != 0 && m_args[short_index - 1].getFlagType() == p_flag.flag_type)
+        return &m_args[short_index - 1];
+    if (long_index != 0 && m_args[long_index - 1].getFlagType() == p_flag.flag_type)
+        return &m_args[long_index - 1];
+    if (short_index == 0 && long_index == 0)
+        return nullptr;
+
+    auto matches = [&](const std::string& p_name) {
+        return m_ignore_flag_case ? Util::equalsFolded(p_flag.name, p_name) : (p_name == p_flag.name);
+    };
+    for (Argument& arg : m_args) {
+        if (arg.getFlagType() != p_flag.flag_type || arg.isPositional() || arg.isVariadic())
+            continue;
+        if ((p_flag.is_short && matches(arg.getShortFlagName())) || (p_flag.is_long && matches(arg.getLongFlagName())))
+            return &arg;
+    }
+
+    return nullptr;
+}
+
+// Use the narrowest flag style that covers the arguments. It's chosen when a
+// parse begins because an argument's flag type can change after it's added.
+void
+Parser::chooseFlagStyle()
+{
+    bool has_dash = false;
+    bool has_slash = false;
+    for (const Argument& arg : m_args) {
+        if (arg.getFlagType() == SLASH_FLAG)
+            has_slash = true;
+        else
+            has_dash = true;
+    }
 
-    return s_no_arg;
+    if (m_spec != nullptr || (has_dash && has_slash))
+        // A spec can hold either kind of flag.
+        m_find_flag = &Parser::findFlag<AnyStyle>;
+    else if (has_slash)
+        m_find_flag = &Parser::findFlag<SlashStyle>;
+    else
+        m_find_flag = &Parser::findFlag<DashStyle>;
+}
+
+// Use a compiled argument table. Only the arguments that every exec looks
+// at (required and environment-bound ones) are created up front; the rest
+// are created the first time their flag or ID is looked up.
+void
+Parser::setSpec(const CompiledSpec* p_spec)
+{
+    // Look up existing arguments without the spec while it's being attached.
+    m_spec = nullptr;
+    if (p_spec == nullptr)
+        return;
+
+    for (size_t i = 0, n = p_spec->size(); i < n; ++i) {
+        if (!p_spec->isRequired(i) && !p_spec->hasEnvVar(i))
+            continue;
+
+        Argument arg = p_spec->getArgument(i);
+        if (!getArgument(arg.getID()).isValidArg())
+            addArgument(arg);
+    }
+
+    m_spec = p_spec;
 }
 
 const ArgumentList_t&
@@ -81,37 +357,31 @@ Parser::getArguments() const
     return m_args;
 }
 
+std::string
+Parser::getHelp() const
+{
+    size_t longest_long_name = 0;
+    for (const Argument& arg : m_args)
+        if (arg.getLongFlagName() != DEFAULT_LONG_FLAG_NAME)
+            longest_long_name = std::max(longest_long_name, arg.getLongFlagName().length());
+
+    std::string result;
+    for (const Argument& arg : m_args)
+        result += arg.toString(longest_long_name) + '\n';
+    return result;
+}
+
 // Boolean testing can be done for internal look-aheads (quietly), or
 // somewhat noisily when evaluating user input.
 ValidBool_t
 Parser::getBoolean(const string& p_value) const
 {
-    bool is_boolean = false;
-
-    // Test for true params.
-    is_boolean |= (0 == strcasecmp("t", p_value.c_str()));
-    is_boolean |= (0 == strcasecmp("true", p_value.c_str()));
-    is_boolean |= (0 == strcasecmp("y", p_value.c_str()));
-    is_boolean |= (0 == strcasecmp("yes", p_value.c_str()));
-    is_boolean |= (0 == strcasecmp("1", p_value.c_str()));
-    is_boolean |= (0 == strcasecmp("on", p_value.c_str()));
-    if (is_boolean)
-        // Return a boolean that is true.
-        return make_pair(true, true);
-
-    // Test for false params.
-    is_boolean |= (0 == strcasecmp("f", p_value.c_str()));
-    is_boolean |= (0 == strcasecmp("false", p_value.c_str()));
-    is_boolean |= (0 == strcasecmp("n", p_value.c_str()));
-    is_boolean |= (0 == strcasecmp("no", p_value.c_str()));
-    is_boolean |= (0 == strcasecmp("0", p_value.c_str()));
-    is_boolean |= (0 == strcasecmp("off", p_value.c_str()));
-    if (is_boolean)
-        // Return a boolean that is false.
-        return make_pair(true, false);
+    bool value = false;
+    if (Util::toBoolean(p_value, value))
+        return make_pair(true, value);
 
 #ifdef DEBUG_BUILD
-    std::cerr << "error[b]: Invalid boolean: " << p_value << '\n';
+    fprintf(stderr, "error[b]: Invalid boolean: %s\n", p_value.c_str());
 #endif
 
     // Don't return a boolean.
@@ -121,42 +391,27 @@ Parser::getBoolean(const string& p_value) const
 ValidInt_t
 Parser::getInteger(const string& p_value) const
 {
-    try {
-        const int int_value = stoi(p_value);
-        const string str_value = to_string(int_value);
-        if (str_value == p_value)
-            return make_pair(true, int_value);
-        else {
-#ifdef DEBUG_BUILD
-            std::cerr << "error[i0]: Invalid integer: " << p_value << '\n';
-#endif
-            return make_pair(false, 0);
-        }
-    } catch (const invalid_argument&) {
+    int value = 0;
+    if (Util::toInteger(p_value.c_str(), value))
+        return make_pair(true, value);
+
 #ifdef DEBUG_BUILD
-        std::cerr << "error[i1]: Invalid integer: " << p_value << '\n';
+    fprintf(stderr, "error[i0]: Invalid integer: %s\n", p_value.c_str());
 #endif
-    }
+
     // Don't return an integer.
-    return make_pair(false, 1);
+    return make_pair(false, 0);
 }
 
 ValidFloat_t
 Parser::getFloat(const string& p_value) const
 {
-    // Convert to a float value.
-    const float f1_value = strtof(p_value.c_str(), nullptr);
-    // Convert the float back to a string value.
-    const string str_value = to_string(f1_value);
-    // Convert to a float (again).
-    const float f2_value = strtof(str_value.c_str(), nullptr);
-    // Compare the strings to see if they are the same.
-    if (AbeMath::isEqual(f1_value, f2_value))
-        // They are the same. It worked.
-        return make_pair(true, f1_value);
+    float value = 0.f;
+    if (Util::toReal(p_value.c_str(), value))
+        return make_pair(true, value);
 
 #ifdef DEBUG_BUILD
-    std::cerr << "error[f0]: Invalid float: " << p_value << '\n';
+    fprintf(stderr, "error[f0]: Invalid float: %s\n", p_value.c_str());
 #endif
 
     // Don't return a float.
@@ -166,19 +421,12 @@ Parser::getFloat(const string& p_value) const
 ValidDouble_t
 Parser::getDouble(const string& p_value) const
 {
-    // Convert to a double value.
-    const double d1_value = strtod(p_value.c_str(), nullptr);
-    // Convert the double back to a string value.
-    const string str_value = to_string(d1_value);
-    // Convert to a double value (again).
-    const double d2_value = strtod(str_value.c_str(), nullptr);
-    // Compare the converted values to see if they are the same.
-    if (AbeMath::isEqual(d1_value, d2_value))
-        // They are the same. It worked.
-        return make_pair(true, d1_value);
+    double value = 0;
+    if (Util::toReal(p_value.c_str(), value))
+        return make_pair(true, value);
 
 #ifdef DEBUG_BUILD
-    std::cerr << "error[d0]: Invalid double: " << p_value << '\n';
+    fprintf(stderr, "error[d0]: Invalid double: %s\n", p_value.c_str());
 #endif
 
     // Don't return a double.
@@ -195,226 +443,908 @@ Parser::fileExists(const char* p_file_path) const
     return false;
 }
 
-ParsedArguments_t
-Parser::exec(int p_argc, char* p_argv[])
+// Convert one param into the argument's value type and check it against the
+// argument's limits in the same pass, for params from the command line and
+// from the other value sources alike. The caller records the diagnostic,
+// since only it knows where the param came from.
+ErrorCode
+Parser::convertValue(const Argument& p_arg, const string& p_param, VarValue_t& p_value) const
+{
+    const ErrorCode code = convertType(p_arg, p_param, p_value);
+    const Validation* validation = p_arg.getValidation();
+    if (code != NO_ERRORS || validation == nullptr)
+        return code;
+
+    return validation->check(p_value);
+}
+
+ErrorCode
+Parser::convertType(const Argument& p_arg, const string& p_param, VarValue_t& p_value) const
+{
+    switch (p_arg.getValueType()) {
+        case STRING_TYPE:
+            p_value = p_param;
+            return NO_ERRORS;
+        case FILE_TYPE:
+            if (!fileExists(p_param.c_str()))
+                return FILE_NOT_FOUND;
+            p_value = p_param;
+            return NO_ERRORS;
+        case BOOLEAN_TYPE: {
+            const auto result = getBoolean(p_param);
+            if (!result.first)
+                return INVALID_BOOLEAN;
+            p_value = result.second;
+            return NO_ERRORS;
+        }
+        case INTEGER_TYPE: {
+            const auto result = getInteger(p_param);
+            if (!result.first)
+                return INVALID_INTEGER;
+            p_value = result.second;
+            return NO_ERRORS;
+        }
+        case FLOAT_TYPE: {
+            const auto result = getFloat(p_param);
+            if (!result.first)
+                return INVALID_FLOAT;
+            p_value = result.second;
+            return NO_ERRORS;
+        }
+        case DOUBLE_TYPE: {
+            const auto result = getDouble(p_param);
+            if (!result.first)
+                return INVALID_DOUBLE;
+            p_value = result.second;
+            return NO_ERRORS;
+        }
+        case INTEGER_LIST_TYPE: {
+            IntList_t list;
+            if (!parseIntegerList(p_param, list))
+                return INVALID_INTEGER;
+            orderIntegerList(list, p_arg.isSortedList(), p_arg.isUniqueList());
+            p_value = std::move(list);
+            return NO_ERRORS;
+        }
+        case CHOICE_TYPE: {
+            const ChoiceTable* choices = p_arg.getChoices();
+            int choice = 0;
+            if (choices == nullptr || !choices->find(p_param, choice))
+                return INVALID_CHOICE;
+            p_value = choice;
+            return NO_ERRORS;
+        }
+        default:
+            break;
+    }
+
+    return INVALID_VALUE;
+}
+
+// Convert a value that didn't come from argv. Multi-param arguments take
+// their params as a comma separated list and keep that list as a string.
+ErrorCode
+Parser::convertSourceValue(const Argument& p_arg, const string& p_param, VarValue_t& p_value) const
+{
+    if (p_arg.isSwitch() || p_arg.isXSwitch()) {
+        const auto result = getBoolean(p_param);
+        if (!result.first)
+            return INVALID_BOOLEAN;
+        p_value = result.second;
+        return NO_ERRORS;
+    }
+
+    const size_t num_params = p_arg.getNumParams();
+    if (num_params <= 1)
+        return convertValue(p_arg, p_param, p_value);
+
+    const Util::StringList params = Util::tokenize(p_param, ',');
+    if (params.size() != num_params)
+        return WRONG_PARAM_COUNT;
+
+    VarValue_t unused;
+    for (const auto& param : params) {
+        const ErrorCode code = convertValue(p_arg, param, unused);
+        if (code != NO_ERRORS)
+            return code;
+    }
+
+    p_value = Util::join(params, ',');
+    return NO_ERRORS;
+}
+
+// Every parsed value goes through here, whatever its source.
+void
+Parser::addResult(ParsedArguments_t& p_results, const Argument& p_arg, const VarValue_t& p_value, ArgumentType p_source)
+{
+    const size_t slot = findSlot(p_arg.getID());
+    if (slot == NO_SLOT)
+        return;
+
+    if (p_arg.getDuplicatePolicy() == ACCUMULATE && holds_alternative<int>(p_value)) {
+        // An accumulated integer is a list from its first value on, so it
+        // has the same type however many times it's given.
+        addResult(p_results, p_arg, IntList_t{ get<int>(p_value) }, p_source);
+        return;
+    }
+
+    if (p_source == ARGV_SOURCE && isPresent(slot) && m_slot_sources[slot] == ARGV_SOURCE) {
+        // The flag was already given on the command line.
+        switch (p_arg.getDuplicatePolicy()) {
+            case FIRST_WINS:
+                return;
+            case DUPLICATE_ERROR:
+                setError({ DUPLICATE_OPTION, p_arg.getID(), m_argv_tokens[m_flag_position], m_flag_position });
+                return;
+            case ACCUMULATE:
+                accumulateValue(m_slot_values[slot], p_value);
+                if (IntList_t* list = get_if<IntList_t>(&m_slot_values[slot]))
+                    orderIntegerList(*list, p_arg.isSortedList(), p_arg.isUniqueList());
+                updateResult(p_results, p_arg, slot);
+                return;
+            default:
+                break;
+        }
+    }
+
+    m_slot_values[slot] = p_value;
+    m_slot_sources[slot] = p_source;
+    m_slot_present[slot / 64] |= (uint64_t(1) << (slot % 64));
+
+    if (m_write_bound) {
+        if (p_arg.isBound())
+            p_arg.writeBinding(m_bound_options, *m_bound_options_type, p_value);
+        return;
+    }
+
+    // With LAST_WINS every occurrence is listed; the last one is in the slot.
+    p_results.push_back(make_pair(p_arg.getID(), p_value));
+}
+
+// Pass on a changed slot value: to the binding, or to the argument's entry
+// in the results (a stream has already handed out the earlier entries).
+void
+Parser::updateResult(ParsedArguments_t& p_results, const Argument& p_arg, size_t p_slot)
+{
+    if (m_write_bound) {
+        if (p_arg.isBound())
+            p_arg.writeBinding(m_bound_options, *m_bound_options_type, m_slot_values[p_slot]);
+        return;
+    }
+
+    for (auto& [arg_ID, value] : p_results) {
+        if (arg_ID == p_arg.getID()) {
+            value = m_slot_values[p_slot];
+            return;
+        }
+    }
+
+    p_results.push_back(make_pair(p_arg.getID(), m_slot_values[p_slot]));
+}
+
+void
+Parser::setEnvironment(char* p_envp[])
+{
+    m_envp = p_envp;
+}
+
+// Index every NAME=VALUE entry of the environment in one pass. The views
+// point into the environment block, so the index is rebuilt for each exec.
+void
+Parser::buildEnvIndex()
+{
+    m_env_index.clear();
+
+    char** envp = (m_envp != nullptr) ? m_envp : ABEARGS_ENVIRON;
+    if (envp == nullptr)
+        return;
+
+    for (char** entry = envp; *entry != nullptr; ++entry) {
+        const string_view name_value{ *entry };
+        const size_t eq_pos = name_value.find('=');
+        if (eq_pos == string_view::npos || eq_pos == 0)
+            continue;
+        // The first definition of a name wins, same as getenv.
+        m_env_index.emplace(name_value.substr(0, eq_pos), name_value.substr(eq_pos + 1));
+    }
+}
+
+void
+Parser::applyEnvironment(ParsedArguments_t& p_results)
+{
+    bool has_env_args = false;
+    for (const Argument& arg : m_args)
+        has_env_args |= arg.hasEnvVar();
+
+    if (!has_env_args)
+        return;
+
+    buildEnvIndex();
+
+    for (const Argument& arg : m_args) {
+        if (!arg.hasEnvVar() || isPresent(findSlot(arg.getID())))
+            // The command line takes precedence over the environment.
+            continue;
+
+        const auto found = m_env_index.find(arg.getEnvVar());
+        if (found == m_env_index.end())
+            continue;
+
+        VarValue_t value;
+        const ErrorCode code = convertSourceValue(arg, string(found->second), value);
+        if (code != NO_ERRORS) {
+            // Point the diagnostic at the name in the environment block.
+            const string_view name{ found->first };
+            setError({ code, arg.getID(), found->second, 0, arg.getNumParams(), name });
+            if (!m_collect_all_errors)
+                return;
+            continue;
+        }
+
+        addResult(p_results, arg, value, ENV_SOURCE);
+        if (arg.isRequired())
+            m_required_args[arg.getID()] = false;
+    }
+}
+
+// Load key=value lines from a config file. Keys are the long flag names of
+// the registered arguments. Blank lines, [section] headers and lines that
+// start with '#' or ';' are skipped; sections don't scope their keys, so a
+// key under any header sets the same argument. A key without a value is a
+// switch that is turned on. The file is scanned in place; only converted
+// values are kept, and they replace the previous file's only when the whole
+// file loads without error.
+bool
+Parser::loadConfigFile(const std::string& p_file_path)
+{
+    clearError();
+
+    // Keep the file mapped so diagnostics can point into it.
+    m_config_path = p_file_path;
+    MappedFile& file = m_config_file;
+    if (!file.open(m_config_path)) {
+        setError({ FILE_NOT_FOUND, NO_ARG, m_config_path });
+        return false;
+    }
+
+    // Resolve keys through the long flag names.
+    unordered_map<string_view, const Argument*> long_names;
+    long_names.reserve(m_args.size());
+    for (const Argument& arg : m_args)
+        if (arg.getLongFlagName() != DEFAULT_LONG_FLAG_NAME)
+            long_names.emplace(arg.getLongFlagName(), &arg);
+
+    map<int, VarValue_t> values;
+    const string_view text = file.view();
+    size_t line_num = 0;
+    for (size_t pos = 0, n = text.size(); pos < n;) {
+        size_t eol = text.find('\n', pos);
+        if (eol == string_view::npos)
+            eol = n;
+
+        const string_view line = Util::trim(text.substr(pos, eol - pos));
+        pos = eol + 1;
+        ++line_num;
+
+        if (line.empty() || line.front() == '#' || line.front() == ';' || line.front() == '[')
+            continue;
+
+        string_view key = line;
+        string_view value = "true";
+        const size_t eq_pos = line.find('=');
+        if (eq_pos != string_view::npos) {
+            key = Util::trim(line.substr(0, eq_pos));
+            value = Util::trim(line.substr(eq_pos + 1));
+            // Strip matching quotes from the value.
+            if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front())
+                value = value.substr(1, value.size() - 2);
+        }
+
+        const Argument* arg = nullptr;
+        Argument spec_arg;
+        const auto found = long_names.find(key);
+        if (found != long_names.end())
+            arg = found->second;
+        else if (m_spec != nullptr) {
+            int spec_index = m_spec->findFlag(string(DEFAULT_LONG_DASH_CHARS) + string(key));
+            if (spec_index < 0)
+                spec_index = m_spec->findFlag(string(DEFAULT_LONG_SLASH_CHARS) + string(key));
+            if (spec_index >= 0) {
+                spec_arg = m_spec->getArgument(spec_index);
+                arg = &spec_arg;
+            }
+        }
+
+        if (arg == nullptr) {
+            setError({ UNRECOGNIZED_CONFIG_KEY, NO_ARG, key, line_num, 0, m_config_path });
+            if (!m_collect_all_errors)
+                return false;
+            continue;
+        }
+
+        VarValue_t converted;
+        const ErrorCode code = convertSourceValue(*arg, string(value), converted);
+        if (code != NO_ERRORS) {
+            setError({ code, arg->getID(), value, line_num, arg->getNumParams(), m_config_path });
+            if (!m_collect_all_errors)
+                return false;
+            continue;
+        }
+
+        // The last definition in the file wins.
+        values[arg->getID()] = std::move(converted);
+    }
+
+    if (error())
+        return false;
+
+    m_config_values.swap(values);
+    return true;
+}
+
+void
+Parser::clearConfigValues()
 {
-    // Combine the exec line into one string for parsing by the parser.
-    // Start at 1 to exclude the executable name (argv[0]).
+    m_config_values.clear();
+    m_config_file.close();
+}
+
+void
+Parser::applyConfigValues(ParsedArguments_t& p_results)
+{
+    if (m_config_values.empty())
+        return;
+
+    for (const auto& [arg_ID, value] : m_config_values) {
+        if (isPresent(findSlot(arg_ID)))
+            // The command line and the environment take precedence.
+            continue;
 
-    std::string argv_str{};
-    for (int i = 1; i < p_argc; ++i) {
-        argv_str += p_argv[i];
-        if (i + 1 < p_argc)
-            argv_str += " ";
+        const Argument& arg = getArgument(arg_ID);
+        addResult(p_results, arg, value, FILE_SOURCE);
+        if (arg.isRequired())
+            m_required_args[arg_ID] = false;
     }
+}
 
-    return exec(argv_str);
+ArgumentType
+Parser::getValueSource(int p_arg_ID) const
+{
+    const size_t slot = findSlot(p_arg_ID);
+    if (slot == NO_SLOT)
+        return NO_ARG;
+
+    if (isPresent(slot))
+        return m_slot_sources[slot];
+
+    return m_args[slot].hasDefaultValue() ? DEFAULT_SOURCE : NO_ARG;
+}
+
+// Combine the exec line into one string for parsing by the parser.
+ParsedArguments_t
+Parser::exec(int p_argc, char* p_argv[])
+{
+    Tokenizer tokenizer(p_argc, p_argv);
+    return execTokens(tokenizer);
 }
 
 ParsedArguments_t
 Parser::exec(const string& p_argv)
+{
+    Tokenizer tokenizer(p_argv);
+    return execTokens(tokenizer);
+}
+
+// Parse with reusable buffers. Like execInto(), the values are only kept in
+// the parser (read them with getResults()) and bound variables, so once the
+// buffers have grown to fit, a parse doesn't allocate.
+bool
+Parser::exec(std::string_view p_argv, ParseContext& p_context)
+{
+    p_context.m_tokenizer.reset(p_argv);
+    return execBound(p_context.m_tokenizer, nullptr, typeid(void));
+}
+
+ParsedArguments_t
+Parser::execTokens(Tokenizer& p_tokenizer)
+{
+    ParsedArguments_t results;
+
+    beginParse();
+    while (parseNext(p_tokenizer, results)) {
+    }
+
+    if (m_exclusive_seen)
+        // An exclusive switch is the only result.
+        return results;
+
+    finishParse(results);
+
+    if (results.empty())
+        // Return the default NO_ARG option.
+        return { make_pair(NO_ARG, std::string(DEFAULT_STR)) };
+
+    return results;
+}
+
+bool
+Parser::execInto(int p_argc, char* p_argv[])
+{
+    Tokenizer tokenizer(p_argc, p_argv);
+    return execBound(tokenizer, nullptr, typeid(void));
+}
+
+bool
+Parser::execInto(const std::string& p_argv)
+{
+    Tokenizer tokenizer(p_argv);
+    return execBound(tokenizer, nullptr, typeid(void));
+}
+
+// Parse without building the results: each value is written to where its
+// argument is bound as soon as it's converted. Arguments that aren't bound
+// are still checked, and getValueSource() tells whether they were given.
+bool
+Parser::execBound(Tokenizer& p_tokenizer, void* p_options, const std::type_info& p_options_type)
+{
+    ParsedArguments_t unused_results;
+
+    m_write_bound = true;
+    m_bound_options = p_options;
+    m_bound_options_type = &p_options_type;
+
+    beginParse();
+    while (parseNext(p_tokenizer, unused_results)) {
+    }
+    if (!m_exclusive_seen)
+        finishParse(unused_results);
+
+    m_write_bound = false;
+    m_bound_options = nullptr;
+    m_bound_options_type = &typeid(void);
+
+    return !m_has_error;
+}
+
+void
+Parser::beginParse()
 {
     clearError();
     resetMissingArgs();
+    std::fill(m_slot_present.begin(), m_slot_present.end(), 0);
+    m_num_argv_tokens = 0;
+    m_flag_position = 0;
+    m_exclusive_seen = false;
+    std::fill(m_slot_occurrences.begin(), m_slot_occurrences.end(), SlotOccurrences{});
+    m_occurrences.clear();
+    for (auto& [arg_ID, value_map] : m_value_maps)
+        value_map.clear();
+    m_next_positional = 0;
+    m_variadic_args = {};
+    m_passthrough_args = {};
+    chooseFlagStyle();
+}
 
-    Argument arg;
-    ParsedArguments_t results;
+// Store the next token so the diagnostics can refer to it.
+// The strings are reused from one parse to the next, and a deque keeps the
+// earlier ones in place while it grows.
+const std::string*
+Parser::pullToken(Tokenizer& p_tokenizer, size_t& p_position, bool p_list)
+{
+    std::string_view token;
+    if (!(p_list ? p_tokenizer.nextList(token) : p_tokenizer.next(token)))
+        return nullptr;
 
-    const char space_char = ' ';
-    const char pairs[] = { '\'', '\'', '"', '"', '(', ')', '[', ']', '{', '}', '<', '>' };
-    const int pairs_len = sizeof(pairs) / sizeof(char);
-
-    // Make a copy of argv.
-    string argv_str = p_argv;
-    // Replace all '=' with ' ' except if within a block of pairs.
-    Util::replaceAll(argv_str, '=', space_char, pairs, pairs_len);
-    // Replace all ',' with ' ' except if within a block of pairs.
-    Util::replaceAll(argv_str, ',', space_char, pairs, pairs_len);
-
-    // Tokenize the arguments (separate with the space_char).
-    m_argv_tokens = Util::tokenize(argv_str, space_char);
-    // Join any tokens surrounded by string_pairs.
-    for (size_t i = 0; i < pairs_len; i = i + 2)
-        m_argv_tokens = Util::joinDelimitedTokens(m_argv_tokens, pairs[i], pairs[i + 1], space_char);
-    // Get the new number of arguments.
-    const size_t argc = m_argv_tokens.size();
-
-    for (size_t i = 0, n = argc; i < n; ++i) {
-        size_t next_i = i + 1;
-        const bool has_next_i = (next_i < n);
-
-        if (error())
-            break;
+    return &storeToken(token, p_position);
+}
 
-        arg = getArgument(m_argv_tokens[i]);
-        if (arg.isValidArg()) {
+std::string&
+Parser::storeToken(std::string_view p_token, size_t& p_position)
+{
+    if (m_num_argv_tokens == m_argv_tokens.size())
+        m_argv_tokens.emplace_back();
 
-            // Arguments can be created with default long and short names.
-            // These defaults signify an empty flag option.
-            // If a user knows the default and tries to use the empty arg name, ignore it.
-            if (arg.matchesDefaultFlag(m_argv_tokens[i])) {
-                setErrorMsg("error: Unrecognized command-line option: " + m_argv_tokens[i]);
-                break;
+    p_position = m_num_argv_tokens++;
+    std::string& stored = m_argv_tokens[p_position];
+    stored.assign(p_token);
+    return stored;
+}
+
+// Parse one flag and its params from the tokenizer. Returns false when there
+// is nothing more to parse from it.
+bool
+Parser::parseNext(Tokenizer& p_tokenizer, ParsedArguments_t& p_results)
+{
+    if (m_exclusive_seen || (m_has_error && !m_collect_all_errors))
+        return false;
+
+    size_t i = 0;
+    const std::string* token = pullToken(p_tokenizer, i);
+    if (token == nullptr)
+        return false;
+
+    m_flag_position = i;
+    if (*token == "--") {
+        // The end of the options: the rest is passed through as it is.
+        m_passthrough_args = takeRest(p_tokenizer, i, false);
+        return false;
+    }
+
+    const Argument* arg = (this->*m_find_flag)(*token);
+
+    // Arguments can be created with default long and short names.
+    // These defaults signify an empty flag option.
+    // If a user knows the default and tries to use the empty arg name, ignore it.
+    if (arg == nullptr || !arg->isValidArg() || arg->matchesDefaultFlag(*token)) {
+        if (isShortCluster(*token))
+            return parseShortCluster(p_tokenizer, *token, i, p_results);
+        if (isPositionalToken(*token))
+            return parsePositional(p_tokenizer, *token, i, p_results);
+
+        setError({ UNRECOGNIZED_OPTION, NO_ARG, *token, i });
+        return true;
+    }
+
+    return parseArgument(p_tokenizer, *arg, *token, i, {}, p_results);
+}
+
+// Parse the params of a flag. The first param is either attached to the
+// flag in a short flag cluster (-ofile) or the next token.
+bool
+Parser::parseArgument(Tokenizer& p_tokenizer,
+                      const Argument& p_arg,
+                      const std::string& p_token,
+                      size_t p_position,
+                      std::string_view p_attached,
+                      ParsedArguments_t& p_results)
+{
+    addOccurrence(p_arg, p_position);
+
+    if (p_arg.isXSwitch()) {
+        // Only handle the first exclusive switch, then stop.
+        p_results.clear();
+        std::fill(m_slot_present.begin(), m_slot_present.end(), 0);
+        addResult(p_results, p_arg, true, ARGV_SOURCE);
+        m_exclusive_seen = true;
+        return false;
+    }
+
+    // Optional and Required flags specify how many params they need and their type.
+    const size_t num_params = p_arg.getNumParams();
+    if (p_arg.isSwitch() && num_params == 0) {
+        if (p_arg.isCountable())
+            addCount(p_results, p_arg);
+        else
+            // The presence of the switch makes it true.
+            addResult(p_results, p_arg, true, ARGV_SOURCE);
+        return true;
+    } else if (num_params == 0 || (p_arg.isSwitch() && num_params > 1)) {
+        return true;
+    }
+
+    if (p_arg.getValueType() == MAP_TYPE)
+        return parseMapEntry(p_tokenizer, p_arg, p_attached, p_results);
+
+    const std::string* param = nullptr;
+    std::string_view param_view;
+    size_t next_i = p_position;
+    if (!p_attached.empty()) {
+        m_attached_param.assign(p_attached);
+        param = &m_attached_param;
+        param_view = p_attached;
+    } else {
+        // A list keeps its commas.
+        param = pullToken(p_tokenizer, next_i, p_arg.getValueType() == INTEGER_LIST_TYPE);
+        if (param == nullptr)
+            // A flag without its params at the end of the line is ignored.
+            return false;
+        param_view = *param;
+    }
+
+    if (p_arg.isSwitch()) {
+        // The value of the switch is defined by the next parameter.
+        const auto result = getBoolean(*param);
+        if (result.first)
+            // If a boolean was found, assign the value.
+            addResult(p_results, p_arg, result.second, ARGV_SOURCE);
+        else
+            setError({ INVALID_BOOLEAN, p_arg.getID(), param_view, next_i });
+    } else if (p_arg.isOptional() || p_arg.isRequired() || p_arg.isPositional()) {
+        if (num_params == 1) {
+            // Verify the type and add to the results.
+            VarValue_t& value = m_slot_converted[findSlot(p_arg.getID())];
+            const ErrorCode code = convertValue(p_arg, *param, value);
+            if (code == NO_ERRORS) {
+                addResult(p_results, p_arg, value, ARGV_SOURCE);
+                if (p_arg.isRequired())
+                    // After seeing and adding the required arg, remove it from the list.
+                    // Later we will know if all required args were used if this list is empty.
+                    m_required_args[p_arg.getID()] = false;
+            } else
+                setError({ code, p_arg.getID(), param_view, next_i });
+
+            return true;
+        }
+
+        // Pull all of the params before checking any of them.
+        const size_t rest_i = m_num_argv_tokens;
+        for (size_t k = 1; k < num_params; ++k) {
+            size_t unused_position = 0;
+            if (pullToken(p_tokenizer, unused_position) == nullptr) {
+                // Not enough tokens left for all of the params.
+                setError({ WRONG_PARAM_COUNT, p_arg.getID(), p_token, p_position, num_params });
+                return false;
             }
+        }
 
-            // Optional and Required flags specify how many params they need and their type.
-            const size_t num_params = arg.getNumParams();
-            const ArgumentType value_type = arg.getValueType();
-            const bool arg_is_string_type = (value_type == STRING_TYPE);
-            const bool arg_is_file_type = (value_type == FILE_TYPE);
-            const bool arg_is_bool_type = (value_type == BOOLEAN_TYPE);
-            const bool arg_is_int_type = (value_type == INTEGER_TYPE);
-            const bool arg_is_float_type = (value_type == FLOAT_TYPE);
-            const bool arg_is_double_type = (value_type == DOUBLE_TYPE);
-
-            if (arg.isXSwitch()) {
-                // Only handle the first exclusive switch, then return.
-                results.clear();
-                results.push_back(make_pair(arg.getID(), true));
-                return results;
-            } else if (arg.isSwitch()) {
-                // Switch flags can have 0 or 1 params.
-                // By default the presence of a switch turns something on (acts true).
-                // When followed by a boolean, it takes the value.
-                if (num_params == 0) {
-                    // The presence of the switch makes it true.
-                    results.push_back(make_pair(arg.getID(), true));
-                    continue;
-                } else if ((num_params == 1) && has_next_i) {
-                    // The value of the switch is defined by the next parameter.
-                    const auto result = getBoolean(m_argv_tokens[next_i]);
-                    if (result.first)
-                        // If a boolean was found, assign the value.
-                        results.push_back(make_pair(arg.getID(), result.second));
-                    else
-                        setErrorMsg("error: Invalid boolean: " + m_argv_tokens[next_i]);
-                    i = next_i;
-                    continue;
-                }
-            } else if (arg.isOptional() || arg.isRequired()) {
-                if ((num_params == 1) && has_next_i) {
-                    const size_t results_before_size = results.size();
-
-                    // Verify the type and add to the results.
-                    if (arg_is_string_type) {
-                        const string param_value = m_argv_tokens[next_i];
-                        results.push_back(make_pair(arg.getID(), param_value));
-                    } else if (arg_is_file_type) {
-                        const char* param_cstr_value = m_argv_tokens[next_i].c_str();
-                        if (fileExists(param_cstr_value))
-                            results.push_back(make_pair(arg.getID(), param_cstr_value));
-                        else
-                            setErrorMsg("error: File not found: " + m_argv_tokens[next_i]);
-                    } else if (arg_is_bool_type) {
-                        const auto result = getBoolean(m_argv_tokens[next_i]);
-                        if (result.first)
-                            results.push_back(make_pair(arg.getID(), result.second));
-                        else
-                            setErrorMsg("error: Invalid boolean: " + m_argv_tokens[next_i]);
-                    } else if (arg_is_int_type) {
-                        const auto result = getInteger(m_argv_tokens[next_i]);
-                        if (result.first)
-                            results.push_back(make_pair(arg.getID(), result.second));
-                        else
-                            setErrorMsg("error: Invalid integer: " + m_argv_tokens[next_i]);
-                    } else if (arg_is_float_type) {
-                        const auto result = getFloat(m_argv_tokens[next_i]);
-                        if (result.first)
-                            results.push_back(make_pair(arg.getID(), result.second));
-                        else
-                            setErrorMsg("error: Invalid float: " + m_argv_tokens[next_i]);
-                    } else if (arg_is_double_type) {
-                        const auto result = getDouble(m_argv_tokens[next_i]);
-                        if (result.first)
-                            results.push_back(make_pair(arg.getID(), result.second));
-                        else
-                            setErrorMsg("error: Invalid double: " + m_argv_tokens[next_i]);
-                    }
-
-                    if (!error()) {
-                        // Compare the before and after size of results.
-                        const bool arg_was_added = (results.size() == results_before_size + 1);
-                        if (arg.isRequired() && arg_was_added) {
-                            // After seeing and adding the required arg, remove it from the list.
-                            // Later we will know if all required args were used if this list is empty.
-                            m_required_args[arg.getID()] = false;
-                        }
-                    }
-
-                    i = next_i;
-                    continue;
-                } else if ((num_params > 1) && has_next_i) {
-                    const size_t results_before_size = results.size();
-
-                    Util::StringList str_results(num_params);
-                    int idx = 0;
-                    // Verify type but pack each into a space separated string.
-                    for (size_t j = next_i, m = next_i + num_params; j < m; ++j, ++i, ++next_i) {
-                        bool result_ok = false;
-                        string value_type_str = {};
-
-                        if (arg_is_bool_type) {
-                            value_type_str = "boolean";
-                            const auto result = getBoolean(m_argv_tokens[j]);
-                            result_ok = result.first;
-                        } else if (arg_is_int_type) {
-                            value_type_str = "int";
-                            const auto result = getInteger(m_argv_tokens[j]);
-                            result_ok = result.first;
-                        } else if (arg_is_float_type) {
-                            value_type_str = "float";
-                            const auto result = getFloat(m_argv_tokens[j]);
-                            result_ok = result.first;
-                        } else if (arg_is_double_type) {
-                            value_type_str = "double";
-                            const auto result = getDouble(m_argv_tokens[j]);
-                            result_ok = result.first;
-                        }
-
-                        if (result_ok) {
-                            str_results[idx++] = m_argv_tokens[j];
-                        } else {
-                            setErrorMsg("error: Invalid " + value_type_str + ": " + m_argv_tokens[j]);
-                            break;
-                        }
-                    }
-
-                    if (!error()) {
-                        results.push_back(make_pair(arg.getID(), Util::join(str_results, ',')));
-
-                        // Compare the before and after size of results.
-                        const bool arg_was_added = (results.size() == results_before_size + 1);
-                        if (arg.isRequired() && arg_was_added) {
-                            // After seeing and adding the required arg, remove it from the list.
-                            // Later we will know if all required args were used if this list is empty.
-                            m_required_args[arg.getID()] = false;
-                        }
-                    }
-                }
+        std::string joined;
+        bool params_ok = true;
+        // Verify type but pack each into a comma separated string.
+        for (size_t k = 0; k < num_params; ++k) {
+            const std::string& value = (k == 0) ? *param : m_argv_tokens[rest_i + k - 1];
+            VarValue_t unused;
+            const ErrorCode code = convertValue(p_arg, value, unused);
+            if (code == NO_ERRORS) {
+                if (k != 0)
+                    joined += ',';
+                joined += value;
+            } else {
+                if (k == 0)
+                    setError({ code, p_arg.getID(), param_view, next_i });
+                else
+                    setError({ code, p_arg.getID(), value, rest_i + k - 1 });
+                params_ok = false;
+                if (!m_collect_all_errors)
+                    break;
             }
-        } else {
-            setErrorMsg("error: Unrecognized command-line option: " + m_argv_tokens[i]);
+        }
+
+        if (params_ok) {
+            addResult(p_results, p_arg, joined, ARGV_SOURCE);
+            if (p_arg.isRequired())
+                // After seeing and adding the required arg, remove it from the list.
+                // Later we will know if all required args were used if this list is empty.
+                m_required_args[p_arg.getID()] = false;
+        }
+    }
+
+    return true;
+}
+
+// A single dash followed by more than one character (-abc).
+bool
+Parser::isShortCluster(const std::string& p_token) const
+{
+    return p_token.size() > 2 && p_token[0] == '-' && p_token[1] != '-';
+}
+
+// Expand -abc into -a -b -c. A flag that takes a value ends the cluster and
+// the rest of the token is its value (-ofile), or the next token if nothing
+// is left.
+bool
+Parser::parseShortCluster(Tokenizer& p_tokenizer, const std::string& p_token, size_t p_position, ParsedArguments_t& p_results)
+{
+    char flag[2] = { p_token[0], 0 };
+
+    // Check every flag of the cluster before using any of them.
+    for (size_t c = 1, n = p_token.size(); c < n; ++c) {
+        flag[1] = p_token[c];
+        const Argument* arg = findFlag<DashStyle>({ flag, 2 });
+        if (arg == nullptr || !arg->isValidArg()) {
+            setError({ UNRECOGNIZED_OPTION, NO_ARG, p_token, p_position });
+            return true;
+        }
+        if (arg->isXSwitch() || arg->getNumParams() > 0)
             break;
+    }
+
+    for (size_t c = 1, n = p_token.size(); c < n; ++c) {
+        flag[1] = p_token[c];
+        const Argument& arg = *findFlag<DashStyle>({ flag, 2 });
+        if (arg.isXSwitch() || arg.getNumParams() > 0) {
+            const std::string_view rest = std::string_view(p_token).substr(c + 1);
+            return parseArgument(p_tokenizer, arg, p_token, p_position, rest, p_results);
         }
+
+        parseArgument(p_tokenizer, arg, p_token, p_position, {}, p_results);
     }
 
-    if (results.empty())
-        // Return the default NO_ARG option.
-        return { make_pair(NO_ARG, std::string(DEFAULT_STR)) };
+    return true;
+}
 
-    return results;
+// Record where the argument's flag was given, so the argv queries don't have
+// to search the tokens. A flag in a cluster (-vvv) is at the cluster's position.
+void
+Parser::addOccurrence(const Argument& p_arg, size_t p_position)
+{
+    const size_t slot = findSlot(p_arg.getID());
+    if (slot == NO_SLOT)
+        return;
+
+    SlotOccurrences& slot_occurrences = m_slot_occurrences[slot];
+    const size_t index = m_occurrences.size();
+    m_occurrences.push_back({ p_position, NO_SLOT });
+    if (slot_occurrences.count == 0)
+        slot_occurrences.first = index;
+    else
+        m_occurrences[slot_occurrences.last].next = index;
+    slot_occurrences.last = index;
+    ++slot_occurrences.count;
+}
+
+// A token that isn't a flag is positional when there's a positional argument
+// left to fill. Anything that starts with a dash but isn't a flag is still
+// an error, except a lone dash (often stdin).
+bool
+Parser::isPositionalToken(const std::string& p_token) const
+{
+    if (p_token.size() > 1 && p_token[0] == '-')
+        return false;
+
+    return m_next_positional < m_positionals.size() || m_variadic != NO_SLOT;
+}
+
+// Fill the next positional argument with the token (and the tokens after it
+// if it takes more than one). Once they're all filled, the token starts the
+// variadic argument, which takes the rest of the command line as it is, so
+// flags after it aren't parsed.
+bool
+Parser::parsePositional(Tokenizer& p_tokenizer, const std::string& p_token, size_t p_position, ParsedArguments_t& p_results)
+{
+    if (m_next_positional < m_positionals.size()) {
+        const Argument& arg = m_args[m_positionals[m_next_positional++]];
+        return parseArgument(p_tokenizer, arg, p_token, p_position, p_token, p_results);
+    }
+
+    const Argument& arg = m_args[m_variadic];
+    addOccurrence(arg, p_position);
+    m_variadic_args = takeRest(p_tokenizer, p_position, true);
+    addResult(p_results, arg, static_cast<int>(m_variadic_args.size()), ARGV_SOURCE);
+    return false;
+}
+
+// The rest of the command line as it is, with or without the token at
+// p_position. From argv, it's a span of the caller's own argv, so nothing is
+// copied. From a string (or a token split off an argv element), the words
+// that are left are stored with the tokens and pointed to. Either way a
+// nullptr follows the span (argv[argc] is one), so it can be given to execv().
+std::span<char* const>
+Parser::takeRest(Tokenizer& p_tokenizer, size_t p_position, bool p_with_token)
+{
+    if (p_tokenizer.isWholeArg())
+        return p_tokenizer.restOfArgv(p_with_token);
+
+    m_rest_tokens.clear();
+    if (p_with_token)
+        m_rest_tokens.push_back(m_argv_tokens[p_position].data());
+
+    std::string_view word;
+    while (p_tokenizer.nextWord(word)) {
+        size_t position = 0;
+        m_rest_tokens.push_back(storeToken(word, position).data());
+    }
+
+    m_rest_tokens.push_back(nullptr);
+    return { m_rest_tokens.data(), m_rest_tokens.size() - 1 };
+}
+
+// Add a KEY=VALUE entry to a map argument. The entry is either attached to a
+// short flag (-DKEY=VALUE) or the next token (--set KEY=VALUE). A key without
+// a value (-DNDEBUG) gets an empty value. The result is the number of entries.
+bool
+Parser::parseMapEntry(Tokenizer& p_tokenizer, const Argument& p_arg, std::string_view p_attached, ParsedArguments_t& p_results)
+{
+    size_t position = m_flag_position;
+    std::string_view key = p_attached;
+    std::string_view value;
+    if (!key.empty()) {
+        // The tokenizer split -DKEY=VALUE at the '=', so the value is the next token.
+        if (p_tokenizer.afterEquals()) {
+            const std::string* param = pullToken(p_tokenizer, position, true);
+            if (param != nullptr)
+                value = *param;
+        }
+    } else {
+        // Read the whole entry, '=' and all.
+        const std::string* param = pullToken(p_tokenizer, position, true);
+        if (param == nullptr)
+            // A flag without its params at the end of the line is ignored.
+            return false;
+
+        const std::string_view entry = *param;
+        const size_t eq_pos = entry.find('=');
+        key = entry.substr(0, eq_pos);
+        if (eq_pos != std::string_view::npos)
+            value = entry.substr(eq_pos + 1);
+    }
+
+    if (key.empty()) {
+        setError({ INVALID_VALUE, p_arg.getID(), m_argv_tokens[position], position });
+        return true;
+    }
+
+    ValueMap& value_map = m_value_maps[p_arg.getID()];
+    const ArgumentType policy = p_arg.getDuplicatePolicy();
+    if (policy == DUPLICATE_ERROR && value_map.contains(key)) {
+        setError({ DUPLICATE_KEY, p_arg.getID(), key, position });
+        return true;
+    }
+    value_map.insert(key, value, policy != FIRST_WINS);
+
+    const int num_entries = static_cast<int>(value_map.size());
+    const size_t slot = findSlot(p_arg.getID());
+    if (!isPresent(slot) || m_slot_sources[slot] != ARGV_SOURCE) {
+        addResult(p_results, p_arg, num_entries, ARGV_SOURCE);
+    } else {
+        m_slot_values[slot] = num_entries;
+        updateResult(p_results, p_arg, slot);
+    }
+
+    if (p_arg.isRequired())
+        m_required_args[p_arg.getID()] = false;
+    return true;
+}
+
+// Each occurrence of a countable switch adds one to its result.
+void
+Parser::addCount(ParsedArguments_t& p_results, const Argument& p_arg)
+{
+    const size_t slot = findSlot(p_arg.getID());
+    if (!isPresent(slot) || m_slot_sources[slot] != ARGV_SOURCE) {
+        addResult(p_results, p_arg, 1, ARGV_SOURCE);
+        return;
+    }
+
+    m_slot_values[slot] = std::get<int>(m_slot_values[slot]) + 1;
+    updateResult(p_results, p_arg, slot);
+}
+
+// Fill in anything not given on the command line from the environment,
+// then from the config files (defaults < file < env < argv).
+void
+Parser::finishParse(ParsedArguments_t& p_results)
+{
+    if (!m_has_error || m_collect_all_errors)
+        applyEnvironment(p_results);
+    if (!m_has_error || m_collect_all_errors)
+        applyConfigValues(p_results);
 }
 
 bool
 Parser::error() const
 {
-    return !m_error_msg.empty();
+    return m_has_error;
 }
 
+// The text is only built here, when someone asks for it.
 std::string
 Parser::getErrorMsg() const
 {
-    return m_error_msg;
+    std::string result;
+    for (const Diagnostic& diagnostic : m_diagnostics) {
+        if (!result.empty())
+            result += '\n';
+        result += diagnostic.toString();
+    }
+    return result;
+}
+
+ErrorCode
+Parser::getErrorCode() const
+{
+    return m_has_error ? m_diagnostics.front().code : NO_ERRORS;
+}
+
+const std::vector<Diagnostic>&
+Parser::getDiagnostics() const
+{
+    return m_diagnostics;
+}
+
+void
+Parser::setCollectAllErrors(bool p_collect_all)
+{
+    m_collect_all_errors = p_collect_all;
 }
 
 void
@@ -427,13 +1357,102 @@ Parser::resetMissingArgs()
 void
 Parser::clearError()
 {
-    m_error_msg.clear();
+    // Keep the capacity; a parse that fails shouldn't allocate.
+    m_diagnostics.clear();
+    m_has_error = false;
+}
+
+void
+Parser::setError(const Diagnostic& p_diagnostic)
+{
+    m_diagnostics.push_back(p_diagnostic);
+    m_has_error = true;
+
+    // Suggest the closest flag to an unrecognized one. Short flags fit the
+    // string's own buffer, so only a long suggestion allocates.
+    if (p_diagnostic.code == UNRECOGNIZED_OPTION && m_suggestion_budget.count() > 0) {
+        buildSuggestions();
+        FlagName flag;
+        const std::string_view name = AnyStyle::strip(p_diagnostic.token, flag) ? flag.name : p_diagnostic.token;
+        FlagSuggester::Match match;
+        if (m_suggester.suggest(name, &match, 1, m_suggestion_budget) > 0)
+            m_diagnostics.back().suggestion.assign(match.flag);
+    }
+
+    // Say what was allowed. The choices and limits are shared, heap allocated
+    // objects, so they outlive the diagnostic even if m_args grows.
+    const size_t slot = findSlot(p_diagnostic.arg_ID);
+    if (slot == NO_SLOT)
+        return;
+
+    const ChoiceTable* choices = m_args[slot].getChoices();
+    const Validation* validation = m_args[slot].getValidation();
+    if (p_diagnostic.code == INVALID_CHOICE && choices != nullptr)
+        m_diagnostics.back().allowed = choices->getNames();
+    else if (p_diagnostic.code == OUT_OF_RANGE && validation != nullptr)
+        m_diagnostics.back().allowed = validation->getRangeText();
+    else if (p_diagnostic.code == INVALID_LENGTH && validation != nullptr)
+        m_diagnostics.back().allowed = validation->getLengthText();
+}
+
+// Limit the time spent finding a suggestion for an unrecognized flag. A zero
+// budget leaves them out of the diagnostics.
+void
+Parser::setSuggestionBudget(std::chrono::microseconds p_budget)
+{
+    m_suggestion_budget = p_budget;
 }
 
+// The registered flags closest to a mistyped one, closest first. They're
+// valid until an argument is added.
+std::vector<std::string_view>
+Parser::suggestFlags(std::string_view p_token, size_t p_max)
+{
+    buildSuggestions();
+
+    FlagName flag;
+    const std::string_view name = AnyStyle::strip(p_token, flag) ? flag.name : p_token;
+    std::vector<FlagSuggester::Match> matches(p_max);
+    matches.resize(m_suggester.suggest(name, matches.data(), p_max, m_suggestion_budget));
+
+    std::vector<std::string_view> flags;
+    flags.reserve(matches.size());
+    for (const FlagSuggester::Match& match : matches)
+        flags.push_back(match.flag);
+    return flags;
+}
+
+// Pool the flags of the arguments and of the spec's arguments that haven't
+// been created yet. The pool is kept until arguments are added.
 void
-Parser::setErrorMsg(const std::string& p_value)
+Parser::buildSuggestions()
 {
-    m_error_msg = p_value;
+    if (m_suggester_args == m_args.size() && m_suggester_spec == m_spec)
+        return;
+
+    m_suggester.clear();
+    auto addFlags = [this](const Argument& p_arg) {
+        if (p_arg.isPositional() || p_arg.isVariadic())
+            return;
+        if (p_arg.getLongFlagName() != DEFAULT_LONG_FLAG_NAME)
+            m_suggester.add(p_arg.getLongFlagChars(), p_arg.getLongFlagName());
+        if (p_arg.getShortFlagName() != DEFAULT_SHORT_FLAG_NAME)
+            m_suggester.add(p_arg.getShortFlagChars(), p_arg.getShortFlagName());
+    };
+
+    for (const Argument& arg : m_args)
+        addFlags(arg);
+
+    if (m_spec != nullptr) {
+        for (size_t i = 0, n = m_spec->size(); i < n; ++i) {
+            const Argument arg = m_spec->getArgument(i);
+            if (findSlot(arg.getID()) == NO_SLOT)
+                addFlags(arg);
+        }
+    }
+
+    m_suggester_args = m_args.size();
+    m_suggester_spec = m_spec;
 }
 
 bool
@@ -446,17 +1465,34 @@ Parser::isMissingRequiredArgs() const
     return missing;
 }
 
+// Whether the argument's flag was given in the last parse.
 bool
 Parser::hasArgvToken(int p_arg_ID) const
 {
-    const Argument arg = getArgument(p_arg_ID);
-    if (Util::contains(m_argv_tokens, arg.getShortFlag()))
-        return true;
+    return getArgvCount(p_arg_ID) > 0;
+}
 
-    if (Util::contains(m_argv_tokens, arg.getLongFlag()))
-        return true;
+// How many times the argument's flag was given in the last parse.
+size_t
+Parser::getArgvCount(int p_arg_ID) const
+{
+    const size_t slot = findSlot(p_arg_ID);
+    return (slot == NO_SLOT) ? 0 : m_slot_occurrences[slot].count;
+}
 
-    return false;
+// The token positions where the argument's flag was given in the last parse.
+std::vector<size_t>
+Parser::getArgvPositions(int p_arg_ID) const
+{
+    std::vector<size_t> positions;
+    const size_t slot = findSlot(p_arg_ID);
+    if (slot == NO_SLOT)
+        return positions;
+
+    positions.reserve(m_slot_occurrences[slot].count);
+    for (size_t i = m_slot_occurrences[slot].first; i != NO_SLOT; i = m_occurrences[i].next)
+        positions.push_back(m_occurrences[i].position);
+    return positions;
 }
 
 } // namespace AbeArgs
@@ -19,16 +19,35 @@
 
 // Project includes
 #include "Argument.h"
+#include "Diagnostic.h"
+#include "FlagStyle.h"
+#include "FlagSuggester.h"
+#include "MappedFile.h"
+#include "ParseContext.h"
+#include "Tokenizer.h"
 #include "Util.h"
+#include "ValueMap.h"
 
 // Standard includes
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <map>
+#include <span>
 #include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
 namespace AbeArgs {
 
+class CompiledSpec;
+class Results;
+
 typedef std::vector<std::pair<int, VarValue_t>> ParsedArguments_t;
 typedef std::vector<Argument> ArgumentList_t;
 typedef std::pair<bool, bool> ValidBool_t;
@@ -38,6 +57,10 @@ typedef std::pair<bool, double> ValidDouble_t;
 
 class Parser
 {
+    friend class ArgumentStream;
+    friend class Results;
+    friend class ResultsSnapshot;
+
   public:
     Parser() = default;
     ~Parser() = default;
@@ -47,16 +70,51 @@ class Parser
     const Argument& getArgument(int p_arg_ID) const;
     Argument& getArgument(const std::string& p_flag);
     const ArgumentList_t& getArguments() const;
+    /// @brief One line per argument, with the descriptions lined up after the longest long name.
+    std::string getHelp() const;
 
     ParsedArguments_t exec(int p_argc, char* p_argv[]);
     ParsedArguments_t exec(const std::string& p_argv);
+
+    bool exec(std::string_view p_argv, ParseContext& p_context);
+
+    bool execInto(int p_argc, char* p_argv[]);
+    bool execInto(const std::string& p_argv);
+    template<class Options_t>
+    bool execInto(int p_argc, char* p_argv[], Options_t& p_options);
+    template<class Options_t>
+    bool execInto(const std::string& p_argv, Options_t& p_options);
+
     bool error() const;
     std::string getErrorMsg() const;
+    ErrorCode getErrorCode() const;
+    const std::vector<Diagnostic>& getDiagnostics() const;
+    void setCollectAllErrors(bool p_collect_all);
+    void setIgnoreFlagCase(bool p_ignore_case);
+    void setSuggestionBudget(std::chrono::microseconds p_budget);
+    std::vector<std::string_view> suggestFlags(std::string_view p_token, size_t p_max = 3);
     bool isMissingRequiredArgs() const;
 
     bool hasArgvToken(int p_arg_ID) const;
+    size_t getArgvCount(int p_arg_ID) const;
+    std::vector<size_t> getArgvPositions(int p_arg_ID) const;
+
+    Results getResults() const;
+    const ValueMap& getValueMap(int p_arg_ID) const;
+    std::span<char* const> getVariadicArgs() const { return m_variadic_args; }
+    std::span<char* const> getPassthroughArgs() const { return m_passthrough_args; }
+    ArgumentType getValueSource(int p_arg_ID) const;
+    void setEnvironment(char* p_envp[]);
+
+    void setSpec(const CompiledSpec* p_spec);
+
+    bool loadConfigFile(const std::string& p_file_path);
+    void clearConfigValues();
 
   private:
+    ParsedArguments_t execTokens(Tokenizer& p_tokenizer);
+    bool execBound(Tokenizer& p_tokenizer, void* p_options, const std::type_info& p_options_type);
+
     ValidBool_t getBoolean(const std::string& p_value) const;
     ValidInt_t getInteger(const std::string& p_value) const;
     ValidFloat_t getFloat(const std::string& p_value) const;
@@ -64,16 +122,176 @@ class Parser
 
     bool fileExists(const char* p_file_path) const;
 
+    ErrorCode convertValue(const Argument& p_arg, const std::string& p_param, VarValue_t& p_value) const;
+    ErrorCode convertType(const Argument& p_arg, const std::string& p_param, VarValue_t& p_value) const;
+    ErrorCode convertSourceValue(const Argument& p_arg, const std::string& p_param, VarValue_t& p_value) const;
+    void addResult(ParsedArguments_t& p_results, const Argument& p_arg, const VarValue_t& p_value, ArgumentType p_source);
+    void updateResult(ParsedArguments_t& p_results, const Argument& p_arg, size_t p_slot);
+
+    size_t findSlot(int p_arg_ID) const;
+    bool isPresent(size_t p_slot) const;
+    const VarValue_t* findValue(int p_arg_ID, bool p_use_default) const;
+
+    void buildEnvIndex();
+    void applyEnvironment(ParsedArguments_t& p_results);
+    void applyConfigValues(ParsedArguments_t& p_results);
+
     void resetMissingArgs();
 
+    void indexFlagNames(size_t p_index);
+    template<class Style_t>
+    Argument* findFlag(std::string_view p_token);
+    Argument* findFlagName(const FlagName& p_flag);
+    void chooseFlagStyle();
+    void buildSuggestions();
+
+    void beginParse();
+    const std::string* pullToken(Tokenizer& p_tokenizer, size_t& p_position, bool p_list = false);
+    std::string& storeToken(std::string_view p_token, size_t& p_position);
+    bool parseNext(Tokenizer& p_tokenizer, ParsedArguments_t& p_results);
+    bool parseArgument(Tokenizer& p_tokenizer,
+                       const Argument& p_arg,
+                       const std::string& p_token,
+                       size_t p_position,
+                       std::string_view p_attached,
+                       ParsedArguments_t& p_results);
+    bool isShortCluster(const std::string& p_token) const;
+    bool parseShortCluster(Tokenizer& p_tokenizer, const std::string& p_token, size_t p_position, ParsedArguments_t& p_results);
+    void addCount(ParsedArguments_t& p_results, const Argument& p_arg);
+    bool isPositionalToken(const std::string& p_token) const;
+    bool parsePositional(Tokenizer& p_tokenizer, const std::string& p_token, size_t p_position, ParsedArguments_t& p_results);
+    std::span<char* const> takeRest(Tokenizer& p_tokenizer, size_t p_position, bool p_with_token);
+    bool parseMapEntry(Tokenizer& p_tokenizer, const Argument& p_arg, std::string_view p_attached, ParsedArguments_t& p_results);
+    void addOccurrence(const Argument& p_arg, size_t p_position);
+    void finishParse(ParsedArguments_t& p_results);
+
     void clearError();
-    void setErrorMsg(const std::string& p_value);
+    void setError(const Diagnostic& p_diagnostic);
 
   private:
+    static constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+
+    /// @brief One occurrence of a flag in argv: its token position and the
+    ///        index of the same argument's next occurrence (NO_SLOT if none).
+    struct Occurrence
+    {
+        size_t position = 0;
+        size_t next = NO_SLOT;
+    };
+
+    /// @brief How many times a slot's flag was given, and its first and last occurrences.
+    struct SlotOccurrences
+    {
+        size_t count = 0;
+        size_t first = NO_SLOT;
+        size_t last = NO_SLOT;
+    };
+
+    /// @brief Hashes names by their text, so a string_view finds a string key.
+    struct NameHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view p_name) const { return Util::hash(p_name); }
+    };
+
     ArgumentList_t m_args;
+    /// @brief Each argument's index in m_args (its slot in the results) by ID.
+    std::unordered_map<int, size_t> m_id_slots;
+    /// @brief The value and source of each slot in the last parse, and a bit for each slot given.
+    std::vector<VarValue_t> m_slot_values;
+    std::vector<ArgumentType> m_slot_sources;
+    std::vector<uint64_t> m_slot_present;
+    /// @brief Each slot's value is converted here first. It keeps its type, and a
+    ///        string keeps its capacity, from one parse to the next.
+    std::vector<VarValue_t> m_slot_converted;
+    /// @brief Where each slot's flag was given in the last parse (the occurrences are reused).
+    std::vector<SlotOccurrences> m_slot_occurrences;
+    std::vector<Occurrence> m_occurrences;
+
+    /// @brief Single character short flags by character (index into m_args + 1, 0 if none).
+    std::array<int, 256> m_short_flags{};
+    /// @brief The other short names and the long names by bare name
+    ///        (index into m_args + 1 of the short and the long name, 0 if none).
+    std::unordered_map<std::string, std::array<int, 2>, NameHash, std::equal_to<>> m_flag_names;
+    /// @brief Match flags ignoring ASCII case (the index holds folded names).
+    bool m_ignore_flag_case = false;
+    /// @brief Holds a folded flag name too long for the stack buffer.
+    std::string m_folded_name;
+    /// @brief The flag lookup for the flag styles in use (chosen when a parse begins).
+    Argument* (Parser::*m_find_flag)(std::string_view) = nullptr;
+    /// @brief The flags to suggest for an unrecognized one, built on the first
+    ///        error after the arguments change.
+    FlagSuggester m_suggester;
+    size_t m_suggester_args = NO_SLOT;
+    const CompiledSpec* m_suggester_spec = nullptr;
+    /// @brief How long an unrecognized flag's suggestion may take (zero turns them off).
+    std::chrono::microseconds m_suggestion_budget = FlagSuggester::DEFAULT_BUDGET;
     std::map<int, bool> m_required_args;
-    Util::StringList m_argv_tokens;
-    std::string m_error_msg;
+    /// @brief The tokens of the last parse (the first m_num_argv_tokens are in use).
+    std::deque<std::string> m_argv_tokens;
+    size_t m_num_argv_tokens = 0;
+    /// @brief An exclusive switch ended the last parse.
+    bool m_exclusive_seen = false;
+    /// @brief The entries of the MAP_TYPE arguments in the last parse (by argument ID).
+    std::map<int, ValueMap> m_value_maps;
+    /// @brief The positional arguments in order and the variadic one (indexes into m_args).
+    std::vector<size_t> m_positionals;
+    size_t m_variadic = NO_SLOT;
+    /// @brief The next positional argument to fill in this parse.
+    size_t m_next_positional = 0;
+    /// @brief The variadic tokens of the last parse: the caller's argv, or m_rest_tokens.
+    std::span<char* const> m_variadic_args;
+    /// @brief The tokens after "--" in the last parse: the caller's argv, or m_rest_tokens.
+    std::span<char* const> m_passthrough_args;
+    /// @brief Points at the stored tokens when the rest of a string is taken as it is
+    ///        (followed by a nullptr, like argv).
+    std::vector<char*> m_rest_tokens;
+
+    /// @brief A value attached to a short flag in a cluster (-ofile).
+    std::string m_attached_param;
+    /// @brief The position of the flag being parsed.
+    size_t m_flag_position = 0;
+
+    /// @brief While set, results are written to the bound variables instead of the results.
+    bool m_write_bound = false;
+    void* m_bound_options = nullptr;
+    const std::type_info* m_bound_options_type = &typeid(void);
+
+    /// @brief The errors of the last parse (formatted only on request).
+    std::vector<Diagnostic> m_diagnostics;
+    bool m_has_error = false;
+    /// @brief Keep parsing after an error and report every diagnostic.
+    bool m_collect_all_errors = false;
+
+    /// @brief The environment block to read from (nullptr means the process environment).
+    char** m_envp = nullptr;
+    std::unordered_map<std::string_view, std::string_view> m_env_index;
+
+    /// @brief Converted values loaded from config files (by argument ID).
+    std::map<int, VarValue_t> m_config_values;
+    /// @brief The last config file loaded, kept mapped for its diagnostics.
+    std::string m_config_path;
+    MappedFile m_config_file;
+
+    /// @brief A compiled argument table to create arguments from on first use.
+    const CompiledSpec* m_spec = nullptr;
 };
 
+/// @brief Parse into the bound variables and the bound members of p_options.
+template<class Options_t>
+bool
+Parser::execInto(int p_argc, char* p_argv[], Options_t& p_options)
+{
+    Tokenizer tokenizer(p_argc, p_argv);
+    return execBound(tokenizer, &p_options, typeid(Options_t));
+}
+
+template<class Options_t>
+bool
+Parser::execInto(const std::string& p_argv, Options_t& p_options)
+{
+    Tokenizer tokenizer(p_argv);
+    return execBound(tokenizer, &p_options, typeid(Options_t));
+}
+
 } // namespace AbeArgs
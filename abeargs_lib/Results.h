@@ -0,0 +1,65 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Project includes
+#include "Argument.h"
+#include "Parser.h"
+
+namespace AbeArgs {
+
+/// @brief Looks up the values of the last parse by argument ID.
+///
+/// Each registered argument has a slot, so has() and get() are a hash lookup
+/// and a bit test instead of a scan of ParsedArguments_t. A value that
+/// wasn't given (on the command line, in the environment or a config file)
+/// falls back to the argument's default. A repeated flag follows the
+/// argument's duplicate policy (see Argument::setDuplicatePolicy).
+/// The view reads from the parser, so it follows the parser's next exec.
+class Results
+{
+  public:
+    explicit Results(const Parser& p_parser)
+      : m_parser(p_parser)
+    {
+    }
+    ~Results() = default;
+
+    /// @brief Whether a value was given for the argument.
+    bool has(int p_arg_ID) const { return m_parser.findValue(p_arg_ID, false) != nullptr; }
+
+    /// @brief Where the value came from (DEFAULT_SOURCE if only a default, NO_ARG if none).
+    ArgumentType getSource(int p_arg_ID) const { return m_parser.getValueSource(p_arg_ID); }
+
+    /// @brief The value given for the argument, else its default, else T{}.
+    ///        Numbers are converted to T.
+    template<class T>
+    T get(int p_arg_ID) const
+    {
+        T result{};
+        const VarValue_t* value = m_parser.findValue(p_arg_ID, true);
+        if (value != nullptr)
+            assignValue(result, *value);
+        return result;
+    }
+
+  private:
+    const Parser& m_parser;
+};
+
+} // namespace AbeArgs
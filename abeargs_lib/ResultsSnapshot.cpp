@@ -0,0 +1,409 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "ResultsSnapshot.h"
+
+// Project includes
+#include "Parser.h"
+#include "Util.h"
+
+// Standard includes
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace AbeArgs {
+
+/// @brief An argument's value in the snapshot.
+struct SnapshotRecord
+{
+    int32_t id;
+    /// @brief The ArgumentType the value came from.
+    uint8_t source;
+    /// @brief The VarValue_t index of the value.
+    uint8_t value_index;
+    uint8_t present;
+    uint8_t reserved;
+    /// @brief The string's length or the list's count.
+    uint32_t size;
+    uint32_t reserved2;
+    /// @brief The bool, int, float or double value, or the pool offset of a string or list.
+    uint64_t bits;
+};
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = { 'A', 'B', 'E', 'S', 'N', 'A', 'P', '\0' };
+
+/// @brief The VarValue_t indexes of the value types.
+enum ValueIndex : uint8_t
+{
+    BOOL_INDEX = 0,
+    INT_INDEX,
+    FLOAT_INDEX,
+    DOUBLE_INDEX,
+    STRING_INDEX,
+    INT_LIST_INDEX,
+};
+
+static_assert(std::is_same_v<std::variant_alternative_t<STRING_INDEX, VarValue_t>, std::string> &&
+              std::is_same_v<std::variant_alternative_t<INT_LIST_INDEX, VarValue_t>, IntList_t>);
+
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t num_records;
+    /// @brief ResultsSnapshot::fingerprint() of the parser that wrote it.
+    uint64_t fingerprint;
+    /// @brief FNV-1a hash of everything after the header.
+    uint64_t content_hash;
+    uint32_t total_size;
+    uint32_t records_offset;
+    uint32_t pool_offset;
+    uint32_t pool_size;
+};
+
+size_t
+align8(size_t p_size)
+{
+    return (p_size + 7) & ~size_t(7);
+}
+
+const SnapshotHeader*
+header(const char* p_data)
+{
+    return reinterpret_cast<const SnapshotHeader*>(p_data);
+}
+
+const SnapshotRecord*
+records(const char* p_data)
+{
+    return reinterpret_cast<const SnapshotRecord*>(p_data + header(p_data)->records_offset);
+}
+
+const char*
+pool(const char* p_data)
+{
+    return p_data + header(p_data)->pool_offset;
+}
+
+// The bytes a record's value takes in the pool.
+size_t
+poolBytes(const SnapshotRecord& p_record)
+{
+    if (p_record.value_index == STRING_INDEX)
+        return p_record.size;
+    if (p_record.value_index == INT_LIST_INDEX)
+        return size_t(p_record.size) * sizeof(int);
+    return 0;
+}
+
+} // namespace
+
+// A hash of what the argument table looks like to a parse: each argument's
+// ID, class, types, param count and flag names, in order.
+uint64_t
+ResultsSnapshot::fingerprint(const Parser& p_parser)
+{
+    auto hashInt = [](int64_t p_value, uint64_t p_seed) {
+        return Util::hash({ reinterpret_cast<const char*>(&p_value), sizeof(p_value) }, p_seed);
+    };
+
+    uint64_t result = Util::hash({ SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC) });
+    for (const Argument& arg : p_parser.getArguments()) {
+        result = hashInt(arg.getID(), result);
+        result = hashInt(arg.getClass(), result);
+        result = hashInt(arg.getValueType(), result);
+        result = hashInt(arg.getFlagType(), result);
+        result = hashInt(static_cast<int64_t>(arg.getNumParams()), result);
+        result = hashInt(static_cast<int64_t>(arg.getShortFlagName().size()), result);
+        result = Util::hash(arg.getShortFlagName(), result);
+        result = hashInt(static_cast<int64_t>(arg.getLongFlagName().size()), result);
+        result = Util::hash(arg.getLongFlagName(), result);
+    }
+    return result;
+}
+
+// Write the values of the parser's last parse: the given ones and the defaults.
+std::string
+ResultsSnapshot::serialize(const Parser& p_parser)
+{
+    const ArgumentList_t& arg_list = p_parser.getArguments();
+
+    std::vector<SnapshotRecord> record_list;
+    std::string value_pool;
+    for (size_t i = 0; i < arg_list.size(); ++i) {
+        // The first of several arguments with the same ID holds the value.
+        const int arg_ID = arg_list[i].getID();
+        if (p_parser.findSlot(arg_ID) != i)
+            continue;
+
+        const VarValue_t* value = p_parser.findValue(arg_ID, true);
+        if (value == nullptr)
+            continue;
+
+        SnapshotRecord record;
+        memset(&record, 0, sizeof(record));
+        record.id = arg_ID;
+        record.source = static_cast<uint8_t>(p_parser.getValueSource(arg_ID));
+        record.value_index = static_cast<uint8_t>(value->index());
+        record.present = p_parser.isPresent(i) ? 1 : 0;
+
+        auto addBytes = [&](const void* p_bytes, size_t p_size) {
+            value_pool.resize(align8(value_pool.size()));
+            record.bits = value_pool.size();
+            value_pool.append(static_cast<const char*>(p_bytes), p_size);
+        };
+
+        if (const bool* b = std::get_if<bool>(value))
+            record.bits = *b ? 1 : 0;
+        else if (const int* n = std::get_if<int>(value))
+            record.bits = static_cast<uint32_t>(*n);
+        else if (const float* f = std::get_if<float>(value))
+            memcpy(&record.bits, f, sizeof(*f));
+        else if (const double* d = std::get_if<double>(value))
+            memcpy(&record.bits, d, sizeof(*d));
+        else if (const std::string* s = std::get_if<std::string>(value)) {
+            record.size = static_cast<uint32_t>(s->size());
+            addBytes(s->data(), s->size());
+        } else if (const IntList_t* list = std::get_if<IntList_t>(value)) {
+            record.size = static_cast<uint32_t>(list->size());
+            addBytes(list->data(), list->size() * sizeof(int));
+        }
+
+        record_list.push_back(record);
+    }
+
+    // Sorted by ID for a binary search.
+    std::stable_sort(record_list.begin(), record_list.end(), [](const SnapshotRecord& p_a, const SnapshotRecord& p_b) {
+        return p_a.id < p_b.id;
+    });
+
+    SnapshotHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    hdr.version = VERSION;
+    hdr.num_records = static_cast<uint32_t>(record_list.size());
+    hdr.fingerprint = fingerprint(p_parser);
+    hdr.records_offset = static_cast<uint32_t>(align8(sizeof(SnapshotHeader)));
+    hdr.pool_offset = static_cast<uint32_t>(hdr.records_offset + record_list.size() * sizeof(SnapshotRecord));
+    hdr.pool_size = static_cast<uint32_t>(value_pool.size());
+    hdr.total_size = static_cast<uint32_t>(hdr.pool_offset + value_pool.size());
+
+    std::string blob(hdr.total_size, '\0');
+    memcpy(&blob[hdr.records_offset], record_list.data(), record_list.size() * sizeof(SnapshotRecord));
+    memcpy(&blob[hdr.pool_offset], value_pool.data(), value_pool.size());
+
+    hdr.content_hash = Util::hash(std::string_view(blob).substr(sizeof(SnapshotHeader)));
+    memcpy(&blob[0], &hdr, sizeof(hdr));
+
+    return blob;
+}
+
+// The IDs of the arguments whose value or presence differs between two
+// snapshots, in ID order. An argument with a value in only one of them counts.
+std::vector<int>
+ResultsSnapshot::changedIDs(const ResultsSnapshot& p_before, const ResultsSnapshot& p_after)
+{
+    auto sameValue = [&](const SnapshotRecord& p_a, const SnapshotRecord& p_b) {
+        if (p_a.present != p_b.present || p_a.value_index != p_b.value_index)
+            return false;
+        if (p_a.value_index < STRING_INDEX)
+            return p_a.bits == p_b.bits;
+        return p_a.size == p_b.size &&
+               memcmp(pool(p_before.m_data) + p_a.bits, pool(p_after.m_data) + p_b.bits, poolBytes(p_a)) == 0;
+    };
+
+    const SnapshotRecord* before = p_before.isOpen() ? records(p_before.m_data) : nullptr;
+    const SnapshotRecord* after = p_after.isOpen() ? records(p_after.m_data) : nullptr;
+    const size_t num_before = p_before.size();
+    const size_t num_after = p_after.size();
+
+    // Both are sorted by ID, so walk them together.
+    std::vector<int> changed;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < num_before || j < num_after) {
+        if (j == num_after || (i < num_before && before[i].id < after[j].id))
+            changed.push_back(before[i++].id);
+        else if (i == num_before || after[j].id < before[i].id)
+            changed.push_back(after[j++].id);
+        else {
+            if (!sameValue(before[i], after[j]))
+                changed.push_back(after[j].id);
+            ++i;
+            ++j;
+        }
+    }
+    return changed;
+}
+
+// View a snapshot in place. The buffer must outlive the reads and be 8-byte
+// aligned. The content hash is checked by verify().
+bool
+ResultsSnapshot::open(std::string_view p_blob, uint64_t p_fingerprint)
+{
+    close();
+    if (!validate(p_blob, p_fingerprint))
+        return false;
+
+    m_data = p_blob.data();
+    return true;
+}
+
+void
+ResultsSnapshot::close()
+{
+    m_data = nullptr;
+}
+
+bool
+ResultsSnapshot::verify() const
+{
+    if (!isOpen())
+        return false;
+
+    const SnapshotHeader* hdr = header(m_data);
+    const std::string_view body(m_data + sizeof(SnapshotHeader), hdr->total_size - sizeof(SnapshotHeader));
+    return (Util::hash(body) == hdr->content_hash);
+}
+
+size_t
+ResultsSnapshot::size() const
+{
+    return isOpen() ? header(m_data)->num_records : 0;
+}
+
+uint64_t
+ResultsSnapshot::getFingerprint() const
+{
+    return isOpen() ? header(m_data)->fingerprint : 0;
+}
+
+bool
+ResultsSnapshot::has(int p_arg_ID) const
+{
+    const SnapshotRecord* record = find(p_arg_ID);
+    return record != nullptr && record->present != 0;
+}
+
+ArgumentType
+ResultsSnapshot::getSource(int p_arg_ID) const
+{
+    const SnapshotRecord* record = find(p_arg_ID);
+    return (record != nullptr) ? static_cast<ArgumentType>(record->source) : NO_ARG;
+}
+
+std::string_view
+ResultsSnapshot::getString(int p_arg_ID) const
+{
+    const SnapshotRecord* record = find(p_arg_ID);
+    if (record == nullptr || record->value_index != STRING_INDEX)
+        return {};
+    return { pool(m_data) + record->bits, record->size };
+}
+
+std::span<const int>
+ResultsSnapshot::getIntList(int p_arg_ID) const
+{
+    const SnapshotRecord* record = find(p_arg_ID);
+    if (record == nullptr || record->value_index != INT_LIST_INDEX)
+        return {};
+    return { reinterpret_cast<const int*>(pool(m_data) + record->bits), record->size };
+}
+
+bool
+ResultsSnapshot::getNumber(int p_arg_ID, Number_t& p_number) const
+{
+    const SnapshotRecord* record = find(p_arg_ID);
+    if (record == nullptr)
+        return false;
+
+    switch (record->value_index) {
+        case BOOL_INDEX:
+            p_number = (record->bits != 0);
+            return true;
+        case INT_INDEX:
+            p_number = static_cast<int>(static_cast<uint32_t>(record->bits));
+            return true;
+        case FLOAT_INDEX: {
+            float value;
+            memcpy(&value, &record->bits, sizeof(value));
+            p_number = value;
+            return true;
+        }
+        case DOUBLE_INDEX: {
+            double value;
+            memcpy(&value, &record->bits, sizeof(value));
+            p_number = value;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+const SnapshotRecord*
+ResultsSnapshot::find(int p_arg_ID) const
+{
+    if (!isOpen())
+        return nullptr;
+
+    const SnapshotRecord* first = records(m_data);
+    const SnapshotRecord* last = first + header(m_data)->num_records;
+    const SnapshotRecord* found =
+      std::lower_bound(first, last, p_arg_ID, [](const SnapshotRecord& p_record, int p_ID) { return p_record.id < p_ID; });
+    return (found != last && found->id == p_arg_ID) ? found : nullptr;
+}
+
+// Check the header and that every record's value lies inside the pool, so
+// the reads can't go past the buffer.
+bool
+ResultsSnapshot::validate(std::string_view p_blob, uint64_t p_fingerprint) const
+{
+    if (p_blob.size() < sizeof(SnapshotHeader) || reinterpret_cast<uintptr_t>(p_blob.data()) % 8 != 0)
+        return false;
+
+    const SnapshotHeader* hdr = header(p_blob.data());
+    if (memcmp(hdr->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+        return false;
+    if (hdr->version != VERSION || hdr->fingerprint != p_fingerprint)
+        // Written by another library version or for other arguments.
+        return false;
+    if (hdr->total_size != p_blob.size() || size_t(hdr->pool_offset) + hdr->pool_size != hdr->total_size)
+        // Truncated or padded.
+        return false;
+    if (hdr->records_offset != align8(sizeof(SnapshotHeader)) ||
+        size_t(hdr->records_offset) + size_t(hdr->num_records) * sizeof(SnapshotRecord) != hdr->pool_offset)
+        return false;
+
+    const SnapshotRecord* record_list = records(p_blob.data());
+    for (uint32_t i = 0; i < hdr->num_records; ++i) {
+        const SnapshotRecord& record = record_list[i];
+        if (record.value_index >= std::variant_size_v<VarValue_t> || (i > 0 && record_list[i - 1].id >= record.id))
+            return false;
+        // Written so a huge offset can't wrap around to a small one.
+        if (record.value_index >= STRING_INDEX &&
+            (record.bits % 8 != 0 || record.bits > hdr->pool_size || poolBytes(record) > hdr->pool_size - record.bits))
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace AbeArgs
@@ -0,0 +1,110 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Project includes
+#include "Argument.h"
+
+// Standard includes
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace AbeArgs {
+
+class Parser;
+struct SnapshotRecord;
+
+/// @brief The values of a completed parse in one flat binary buffer, to hand
+///        to other processes (through a pipe or shared memory) instead of argv.
+///
+/// The buffer holds a record for each argument with a value, sorted by ID,
+/// and a pool of the string and list values. It only holds offsets, so it
+/// can be read wherever it lands, as long as it's 8-byte aligned. open()
+/// views the buffer in place and checks the header, the bounds of every
+/// record, and the fingerprint of the argument table. The fingerprint
+/// covers each argument's ID, class, types, param count and flag names, so
+/// a reader built from different arguments is refused. The numbers are
+/// stored in the host's byte order. Strings are returned as string_views and
+/// lists as spans into the buffer, so reading a value doesn't allocate.
+/// MAP_TYPE entries and the variadic and passthrough tokens view argv, so
+/// they aren't included.
+class ResultsSnapshot
+{
+  public:
+    static const uint32_t VERSION = 1;
+
+  public:
+    ResultsSnapshot() = default;
+    ~ResultsSnapshot() = default;
+
+    static uint64_t fingerprint(const Parser& p_parser);
+    static std::string serialize(const Parser& p_parser);
+    static std::vector<int> changedIDs(const ResultsSnapshot& p_before, const ResultsSnapshot& p_after);
+
+    bool open(std::string_view p_blob, uint64_t p_fingerprint);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    bool verify() const;
+    size_t size() const;
+    uint64_t getFingerprint() const;
+
+    /// @brief Whether a value was given for the argument (not only a default).
+    bool has(int p_arg_ID) const;
+    /// @brief Where the value came from (DEFAULT_SOURCE if only a default, NO_ARG if none).
+    ArgumentType getSource(int p_arg_ID) const;
+    std::string_view getString(int p_arg_ID) const;
+    std::span<const int> getIntList(int p_arg_ID) const;
+
+    /// @brief The value given for the argument, else its default, else T{}.
+    ///        Numbers are converted to T; strings are std::string_view and
+    ///        lists std::span<const int>.
+    template<class T>
+    T get(int p_arg_ID) const
+    {
+        if constexpr (std::is_same_v<T, std::string_view>)
+            return getString(p_arg_ID);
+        else if constexpr (std::is_same_v<T, std::span<const int>>)
+            return getIntList(p_arg_ID);
+        else {
+            static_assert(std::is_arithmetic_v<T>, "Read strings as std::string_view and lists as std::span<const int>");
+            T result{};
+            Number_t number;
+            if (getNumber(p_arg_ID, number))
+                std::visit([&result](auto p_value) { result = static_cast<T>(p_value); }, number);
+            return result;
+        }
+    }
+
+  private:
+    typedef std::variant<bool, int, float, double> Number_t;
+
+    bool getNumber(int p_arg_ID, Number_t& p_number) const;
+    const SnapshotRecord* find(int p_arg_ID) const;
+    bool validate(std::string_view p_blob, uint64_t p_fingerprint) const;
+
+  private:
+    const char* m_data = nullptr;
+};
+
+} // namespace AbeArgs
@@ -0,0 +1,277 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "Tokenizer.h"
+
+// Standard includes
+#include <algorithm>
+
+namespace AbeArgs {
+
+namespace {
+
+const char s_pairs[] = { '\'', '\'', '"', '"', '(', ')', '[', ']', '{', '}', '<', '>' };
+const int s_num_pairs = sizeof(s_pairs) / 2;
+
+} // namespace
+
+void
+Tokenizer::reset(std::string_view p_input)
+{
+    m_input = p_input;
+    m_pos = 0;
+    m_argv = nullptr;
+    m_argc = 0;
+    m_arg_index = 0;
+    m_token_arg = 0;
+    m_token_is_whole_arg = false;
+    m_block_open = false;
+    m_which_pair = -1;
+}
+
+// Read argv in place, starting after the executable name (argv[0]).
+void
+Tokenizer::reset(int p_argc, char* p_argv[])
+{
+    reset(std::string_view{});
+    m_argv = p_argv;
+    m_argc = p_argc;
+    m_arg_index = 0;
+}
+
+// Move on to the next argv element (the end of an element is a space).
+bool
+Tokenizer::nextArg()
+{
+    if (m_argv == nullptr || m_arg_index + 1 >= m_argc)
+        return false;
+
+    m_input = m_argv[++m_arg_index];
+    m_pos = 0;
+    return true;
+}
+
+// Remember where a token starts (before any joining).
+void
+Tokenizer::markToken(std::string_view p_raw)
+{
+    m_token_arg = m_arg_index;
+    m_token_is_whole_arg = p_raw.data() == m_input.data() && p_raw.size() == m_input.size();
+}
+
+// The argv elements from the last token's element on (p_with_token), or
+// after it. They're the caller's own argv, so nothing is copied.
+std::span<char* const>
+Tokenizer::restOfArgv(bool p_with_token) const
+{
+    if (m_argv == nullptr)
+        return {};
+
+    // An empty rest still points at argv[argc].
+    const int first = std::min(p_with_token ? m_token_arg : m_token_arg + 1, m_argc);
+    return { m_argv + first, static_cast<size_t>(m_argc - first) };
+}
+
+// Join blocks of pairs in the caller's bytes rather than in m_joined. Each
+// joined token starts at the front of the buffer and ends with a NUL, so the
+// caller moves the buffer past getJoinedSize() bytes to keep it.
+void
+Tokenizer::setJoinBuffer(std::span<char> p_buffer)
+{
+    m_join_buffer = p_buffer;
+    m_has_join_buffer = true;
+}
+
+int
+Tokenizer::openerIndex(char p_c) const
+{
+    for (int i = 0; i < s_num_pairs; ++i)
+        if (p_c == s_pairs[i * 2])
+            return i;
+    return -1;
+}
+
+// The next run of characters up to a separator.
+bool
+Tokenizer::nextRaw(std::string_view& p_raw)
+{
+    do {
+        if (nextRawInArg(p_raw))
+            return true;
+    } while (nextArg());
+
+    return false;
+}
+
+// The next run of characters up to a separator in the current string or
+// argv element.
+bool
+Tokenizer::nextRawInArg(std::string_view& p_raw)
+{
+    const size_t n = m_input.size();
+    while (m_pos < n) {
+        const size_t start = m_pos;
+        for (; m_pos < n; ++m_pos) {
+            const char c = m_input[m_pos];
+
+            // Track blocks of pairs the way Util::replaceAll does.
+            if (!m_block_open) {
+                const int pair = openerIndex(c);
+                if (pair >= 0) {
+                    m_block_open = true;
+                    m_which_pair = pair;
+                }
+            } else if (c == s_pairs[m_which_pair * 2 + 1]) {
+                m_block_open = false;
+                m_which_pair = -1;
+            }
+
+            if (c == ' ' || (!m_block_open && (c == '=' || c == ',')))
+                break;
+        }
+
+        const size_t end = m_pos;
+        if (m_pos < n)
+            // Step over the separator.
+            ++m_pos;
+
+        if (end > start) {
+            p_raw = m_input.substr(start, end - start);
+            return true;
+        }
+        // Skip empty tokens between separators.
+    }
+
+    return false;
+}
+
+// Add to the token being joined. Only the join buffer can run out of room.
+bool
+Tokenizer::appendJoined(std::string_view p_text)
+{
+    if (!m_has_join_buffer) {
+        m_joined += p_text;
+        return true;
+    }
+
+    if (m_join_buffer.size() - m_joined_size < p_text.size())
+        return false;
+
+    std::copy(p_text.begin(), p_text.end(), m_join_buffer.begin() + m_joined_size);
+    m_joined_size += p_text.size();
+    return true;
+}
+
+bool
+Tokenizer::next(std::string_view& p_token)
+{
+    m_joined_size = 0;
+    m_join_overflowed = false;
+
+    std::string_view raw;
+    if (!nextRaw(raw))
+        return false;
+
+    markToken(raw);
+    const int pair = openerIndex(raw.front());
+    if (pair < 0) {
+        p_token = raw;
+        return true;
+    }
+
+    const char closer = s_pairs[pair * 2 + 1];
+    if (raw.back() == closer) {
+        // The whole block is in one token (a lone opener is empty).
+        p_token = raw.size() > 1 ? raw.substr(1, raw.size() - 2) : std::string_view();
+        return true;
+    }
+
+    // Join the tokens up to the one that ends with the closer.
+    m_token_is_whole_arg = false;
+    m_joined.clear();
+    bool fits = appendJoined(raw);
+    bool closed = false;
+    while (fits && !closed && nextRaw(raw)) {
+        fits = appendJoined(" ") && appendJoined(raw);
+        closed = (raw.back() == closer);
+    }
+
+    std::string_view joined = m_joined;
+    if (m_has_join_buffer) {
+        joined = { m_join_buffer.data(), m_joined_size };
+        if (fits && m_joined_size < m_join_buffer.size())
+            m_join_buffer[m_joined_size++] = 0;
+        else
+            fits = false;
+    }
+
+    if (!fits) {
+        // What did fit, for the caller's diagnostic.
+        m_join_overflowed = true;
+        m_joined_size = 0;
+        p_token = joined;
+        return false;
+    }
+
+    // An unclosed block keeps its opener.
+    p_token = closed ? joined.substr(1, joined.size() - 2) : joined;
+    return true;
+}
+
+// The next token up to a space, with its commas kept (a list value such as
+// 1,2,10-20). A pair around the whole list is removed ([1,2,3]).
+bool
+Tokenizer::nextList(std::string_view& p_token)
+{
+    if (!nextWord(p_token))
+        return false;
+
+    const int pair = openerIndex(p_token.front());
+    if (pair >= 0 && p_token.size() > 1 && p_token.back() == s_pairs[pair * 2 + 1])
+        p_token = p_token.substr(1, p_token.size() - 2);
+
+    return true;
+}
+
+// The next token up to a space, as it is.
+bool
+Tokenizer::nextWord(std::string_view& p_token)
+{
+    do {
+        const size_t n = m_input.size();
+        while (m_pos < n && m_input[m_pos] == ' ')
+            ++m_pos;
+
+        if (m_pos < n) {
+            const size_t start = m_pos;
+            while (m_pos < n && m_input[m_pos] != ' ')
+                ++m_pos;
+
+            p_token = m_input.substr(start, m_pos - start);
+            if (m_pos < n)
+                // Step over the separator.
+                ++m_pos;
+
+            markToken(p_token);
+            return true;
+        }
+    } while (nextArg());
+
+    return false;
+}
+
+} // namespace AbeArgs
@@ -0,0 +1,104 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Standard includes
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace AbeArgs {
+
+/// @brief Splits a command line into tokens one at a time, on demand.
+///
+/// Tokens are separated by spaces, and by '=' and ',' outside of a block
+/// of pairs ('', "", (), [], {}, <>). A token that starts with an opener is
+/// joined with the tokens that follow it up to one that ends with the
+/// matching closer, and the outer pair is removed. This is the same split
+/// that Util::replaceAll, Util::tokenize and Util::joinDelimitedTokens
+/// produce together, done in a single pass without copying the input.
+///
+/// The input is either one string or the elements of argv (after argv[0]),
+/// read in place as if they were joined with spaces. A joined token is built
+/// in the tokenizer's own string, or in the caller's bytes when it's given a
+/// join buffer (so it never allocates).
+class Tokenizer
+{
+  public:
+    Tokenizer() = default;
+    explicit Tokenizer(std::string_view p_input) { reset(p_input); }
+    Tokenizer(int p_argc, char* p_argv[]) { reset(p_argc, p_argv); }
+    ~Tokenizer() = default;
+
+    void reset(std::string_view p_input);
+    void reset(int p_argc, char* p_argv[]);
+
+    bool next(std::string_view& p_token);
+    bool nextList(std::string_view& p_token);
+    bool nextWord(std::string_view& p_token);
+
+    /// @brief Whether the last token is a whole argv element (not split off one or joined).
+    bool isWholeArg() const { return m_argv != nullptr && m_token_is_whole_arg; }
+    std::span<char* const> restOfArgv(bool p_with_token) const;
+    /// @brief Whether the last token ended at an '=' (rather than a space or ',').
+    bool afterEquals() const { return m_pos > 0 && m_pos <= m_input.size() && m_input[m_pos - 1] == '='; }
+
+    void setJoinBuffer(std::span<char> p_buffer);
+    /// @brief The bytes of the join buffer the last token took (with its NUL), or 0.
+    size_t getJoinedSize() const { return m_joined_size; }
+    /// @brief Whether next() stopped at a block of pairs that didn't fit the join buffer.
+    bool joinOverflowed() const { return m_join_overflowed; }
+
+  private:
+    bool nextRaw(std::string_view& p_raw);
+    bool nextRawInArg(std::string_view& p_raw);
+    bool nextArg();
+    void markToken(std::string_view p_raw);
+    int openerIndex(char p_c) const;
+    bool appendJoined(std::string_view p_text);
+
+  private:
+    /// @brief The string (or argv element) being read.
+    std::string_view m_input = {};
+    size_t m_pos = 0;
+
+    /// @brief The argv elements (nullptr when reading a string) and the one in m_input.
+    char* const* m_argv = nullptr;
+    int m_argc = 0;
+    int m_arg_index = 0;
+
+    /// @brief The argv element the last token started in, and whether it's the whole element.
+    int m_token_arg = 0;
+    bool m_token_is_whole_arg = false;
+
+    /// @brief Whether '=' and ',' are inside a block of pairs (and which pair).
+    bool m_block_open = false;
+    int m_which_pair = -1;
+
+    /// @brief Holds a joined token (its capacity is reused).
+    std::string m_joined = {};
+
+    /// @brief The caller's bytes for joined tokens, used instead of m_joined when set.
+    std::span<char> m_join_buffer = {};
+    bool m_has_join_buffer = false;
+    size_t m_joined_size = 0;
+    bool m_join_overflowed = false;
+};
+
+} // namespace AbeArgs
@@ -18,15 +18,24 @@
 #pragma once
 
 // Project includes
+#include "AbeMath.h"
 #ifdef _MSC_VER
 #include "MSVC.h"
 #endif
 
 // Standard includes
 #include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <initializer_list>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace AbeArgs {
@@ -265,6 +274,87 @@ class Util
         return result;
     }
 
+    /// @brief 64-bit FNV-1a hash of a run of bytes.
+    /// @param p_bytes The bytes to hash
+    /// @param p_seed The starting hash value (chain calls by passing the previous hash)
+    /// @return The hash value
+    static uint64_t hash(std::string_view p_bytes, uint64_t p_seed = 14695981039346656037ull)
+    {
+        uint64_t h = p_seed;
+        for (const char c : p_bytes) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    /// @brief Trim spaces, tabs and carriage returns from both ends of a view.
+    /// @param p_view The view to trim
+    /// @return The trimmed view (into the same characters)
+    static std::string_view trim(std::string_view p_view)
+    {
+        const char* whitespace = " \t\r";
+        const size_t first = p_view.find_first_not_of(whitespace);
+        if (first == std::string_view::npos)
+            return {};
+
+        const size_t last = p_view.find_last_not_of(whitespace);
+        return p_view.substr(first, last - first + 1);
+    }
+
+    /// @brief Fold an ASCII upper case letter to lower case (without a branch).
+    /// @param p_c The char to fold
+    /// @return The folded char
+    static char foldCase(char p_c)
+    {
+        const unsigned char c = static_cast<unsigned char>(p_c);
+        return static_cast<char>(c | (static_cast<unsigned char>(c - 'A') < 26) << 5);
+    }
+
+    /// @brief Fold the ASCII upper case letters of a string to lower case,
+    ///        eight chars at a time. Other bytes are copied as they are.
+    /// @param p_str The string to fold
+    /// @param p_out Where to write the p_str.size() folded chars (may be p_str itself)
+    static void foldCase(std::string_view p_str, char* p_out)
+    {
+        const uint64_t ones = 0x0101010101010101ull;
+        const uint64_t highs = 0x8080808080808080ull;
+
+        size_t i = 0;
+        for (const size_t n = p_str.size(); i + 8 <= n; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, p_str.data() + i, 8);
+
+            // Per byte: the high bit is set if the byte is in 'A'..'Z'
+            // (bytes over 0x7f are left alone).
+            const uint64_t low7 = word & ~highs;
+            const uint64_t above_z = low7 + ones * (0x7f - 'Z');
+            const uint64_t from_a = low7 + ones * (0x80 - 'A');
+            const uint64_t upper = (from_a ^ above_z) & ~word & highs;
+
+            word |= upper >> 2;
+            std::memcpy(p_out + i, &word, 8);
+        }
+
+        for (; i < p_str.size(); ++i)
+            p_out[i] = foldCase(p_str[i]);
+    }
+
+    /// @brief Compare a string to one that's already folded, ignoring ASCII case.
+    /// @param p_folded The folded string
+    /// @param p_str The string to fold and compare
+    /// @return A boolean (yes/no) if they're the same
+    static bool equalsFolded(std::string_view p_folded, std::string_view p_str)
+    {
+        if (p_folded.size() != p_str.size())
+            return false;
+
+        for (size_t i = 0; i < p_str.size(); ++i)
+            if (foldCase(p_str[i]) != p_folded[i])
+                return false;
+        return true;
+    }
+
     static std::string toLowerStr(const std::string& p_word_str)
     {
         std::string my_word_str = p_word_str;
@@ -275,6 +365,76 @@ class Util
         return my_word_str;
     }
 
+    /// @brief Read a boolean word: t, true, y, yes, 1 or on, or f, false, n,
+    ///        no, 0 or off, in any case.
+    /// @param p_value The word
+    /// @param p_result Set to the value, if it's a boolean word
+    /// @return A boolean (yes/no) if it's a boolean word
+    static bool toBoolean(std::string_view p_value, bool& p_result)
+    {
+        for (const std::string_view word : { "t", "true", "y", "yes", "1", "on" }) {
+            if (equalsFolded(word, p_value)) {
+                p_result = true;
+                return true;
+            }
+        }
+        for (const std::string_view word : { "f", "false", "n", "no", "0", "off" }) {
+            if (equalsFolded(word, p_value)) {
+                p_result = false;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Read an integer that's only its own digits (printing it gives
+    ///        the text back). It doesn't allocate or throw.
+    /// @param p_value The NUL terminated text
+    /// @param p_result Set to the value, if it's an integer
+    /// @return A boolean (yes/no) if it's an integer
+    static bool toInteger(const char* p_value, int& p_result)
+    {
+        errno = 0;
+        char* end = nullptr;
+        const long value = strtol(p_value, &end, 10);
+        if (end == p_value || errno == ERANGE || value < INT_MIN || value > INT_MAX)
+            return false;
+
+        char text[32];
+        snprintf(text, sizeof(text), "%d", static_cast<int>(value));
+        if (strcmp(text, p_value) != 0)
+            return false;
+
+        p_result = static_cast<int>(value);
+        return true;
+    }
+
+    /// @brief Read a float or double that survives being printed with "%f"
+    ///        (the way std::to_string() prints it). It doesn't allocate or throw.
+    /// @param p_value The NUL terminated text
+    /// @param p_result Set to the value, if it's a number
+    /// @return A boolean (yes/no) if it's a number
+    template<class T>
+    static bool toReal(const char* p_value, T& p_result)
+    {
+        auto convert = [](const char* p_text) {
+            if constexpr (std::is_same_v<T, float>)
+                return strtof(p_text, nullptr);
+            else
+                return strtod(p_text, nullptr);
+        };
+
+        const T value = convert(p_value);
+        // Wide enough for "%f" of the largest double.
+        char text[512];
+        snprintf(text, sizeof(text), "%f", static_cast<double>(value));
+        if (!AbeMath::isEqual(value, convert(text)))
+            return false;
+
+        p_result = value;
+        return true;
+    }
+
     static bool compareStr(const std::string& p_lhs,
                            const std::string& p_rhs,
                            bool p_ignore_case = true)
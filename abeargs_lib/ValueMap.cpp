@@ -0,0 +1,95 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#include "ValueMap.h"
+
+// Project includes
+#include "Util.h"
+
+// Standard includes
+#include <algorithm>
+
+namespace AbeArgs {
+
+// Add an entry. A key that's already there gets the new value if
+// p_replace is set. Returns whether the key is new.
+bool
+ValueMap::insert(std::string_view p_key, std::string_view p_value, bool p_replace)
+{
+    if ((m_entries.size() + 1) * 2 > m_slots.size())
+        grow();
+
+    const uint64_t hash = Util::hash(p_key);
+    const size_t slot = findSlot(p_key, hash);
+    if (m_slots[slot] != 0) {
+        if (p_replace)
+            m_entries[m_slots[slot] - 1].value = p_value;
+        return false;
+    }
+
+    m_entries.push_back({ p_key, p_value });
+    m_hashes.push_back(hash);
+    m_slots[slot] = static_cast<uint32_t>(m_entries.size());
+    return true;
+}
+
+// The value of the key, or nullptr if it isn't there.
+const std::string_view*
+ValueMap::find(std::string_view p_key) const
+{
+    if (m_entries.empty())
+        return nullptr;
+
+    const size_t slot = findSlot(p_key, Util::hash(p_key));
+    return (m_slots[slot] == 0) ? nullptr : &m_entries[m_slots[slot] - 1].value;
+}
+
+void
+ValueMap::clear()
+{
+    m_entries.clear();
+    m_hashes.clear();
+    std::fill(m_slots.begin(), m_slots.end(), 0);
+}
+
+// The slot of the key, or the empty slot where it goes (linear probing).
+size_t
+ValueMap::findSlot(std::string_view p_key, uint64_t p_hash) const
+{
+    const size_t mask = m_slots.size() - 1;
+    for (size_t slot = p_hash & mask;; slot = (slot + 1) & mask) {
+        const uint32_t entry = m_slots[slot];
+        if (entry == 0 || (m_hashes[entry - 1] == p_hash && m_entries[entry - 1].key == p_key))
+            return slot;
+    }
+}
+
+void
+ValueMap::grow()
+{
+    m_slots.assign(std::max<size_t>(16, m_slots.size() * 2), 0);
+
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        size_t slot = m_hashes[i] & mask;
+        while (m_slots[slot] != 0)
+            slot = (slot + 1) & mask;
+        m_slots[slot] = static_cast<uint32_t>(i + 1);
+    }
+}
+
+} // namespace AbeArgs
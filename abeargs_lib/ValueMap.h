@@ -0,0 +1,73 @@
+/**
+ *           d8888 888                     d8888
+ *          d88888 888                    d88888
+ *         d88P888 888                   d88P888
+ *        d88P 888 88888b.   .d88b.     d88P 888 888d888 .d88b.  .d8888b
+ *       d88P  888 888 "88b d8P  Y8b   d88P  888 888P"  d88P"88b 88K
+ *      d88P   888 888  888 88888888  d88P   888 888    888  888 "Y8888b.
+ *     d8888888888 888 d88P Y8b.     d8888888888 888    Y88b 888      X88
+ *    d88P     888 88888P"   "Y8888 d88P     888 888     "Y88888  88888P'
+ *                                                           888
+ * ~$ Command Line Argument Processing Simplified       Y8b d88P
+ *                                                       "Y88P"
+ * Copyright (c) 2025, Abe Mishler
+ * Licensed under the Universal Permissive License v 1.0
+ * as shown at https://oss.oracle.com/licenses/upl/.
+ */
+
+#pragma once
+
+// Standard includes
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace AbeArgs {
+
+/// @brief The KEY=VALUE entries of a MAP_TYPE argument (-DNAME=VALUE, --set key=value).
+///
+/// The keys and values view the parser's tokens, so they're valid until the
+/// next parse. The entries are kept in one vector in the order they were
+/// first given, and an open-addressing table of entry indexes finds them by
+/// key. Nothing is allocated per entry, and clear() keeps the capacity for
+/// the next parse.
+class ValueMap
+{
+  public:
+    struct Entry
+    {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    ValueMap() = default;
+    ~ValueMap() = default;
+
+    bool insert(std::string_view p_key, std::string_view p_value, bool p_replace = true);
+    const std::string_view* find(std::string_view p_key) const;
+    bool contains(std::string_view p_key) const { return find(p_key) != nullptr; }
+    void clear();
+
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+
+    /// @brief The entries in the order their keys were first given.
+    const std::vector<Entry>& getEntries() const { return m_entries; }
+    std::vector<Entry>::const_iterator begin() const { return m_entries.begin(); }
+    std::vector<Entry>::const_iterator end() const { return m_entries.end(); }
+
+  private:
+    size_t findSlot(std::string_view p_key, uint64_t p_hash) const;
+    void grow();
+
+  private:
+    std::vector<Entry> m_entries;
+    /// @brief The hash of each entry's key (so growing doesn't hash them again).
+    std::vector<uint64_t> m_hashes;
+
+    /// @brief Entry index + 1 by hash slot (0 is empty). Its size is a power
+    ///        of two, and it's kept at most half full.
+    std::vector<uint32_t> m_slots;
+};
+
+} // namespace AbeArgs
@@ -16,5 +16,21 @@
  */
 
 #include "Argument.h"
+#include "ArgumentStream.h"
+#include "ChoiceTable.h"
+#include "CompiledSpec.h"
 #include "Defaults.h"
+#include "Diagnostic.h"
+#include "FixedParser.h"
+#include "FlagStyle.h"
+#include "FlagSuggester.h"
+#include "IntegerList.h"
+#include "LineDispatcher.h"
+#include "MappedFile.h"
+#include "OptionsStore.h"
+#include "ParseContext.h"
 #include "Parser.h"
+#include "Results.h"
+#include "ResultsSnapshot.h"
+#include "Tokenizer.h"
+#include "ValueMap.h"
@@ -19,9 +19,27 @@
 
 // Project includes
 #include "../abeargs_lib/abeargs.h"
+#include "TestOptions.h"
 
 // System includes
+#if defined(__linux__)
+#include <ar.h>
+#include <elf.h>
+#endif
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <thread>
 
 using namespace AbeArgs;
 using namespace std;
@@ -379,11 +397,14 @@ ParserTests::testArgPrint()
     parser.addArgument({ X_SWITCH, ARG_ID_3, "v", "version", "Show version info" });
 
     cout << "\n-----\n";
-    ArgumentList_t list = parser.getArguments();
-    for (const auto& arg : list)
-        cout << arg.toString() << '\n';
-
+    const string help = parser.getHelp();
+    cout << help;
     cout << "-----\n";
+
+    // The descriptions line up after the longest long name.
+    const size_t help_line = help.find("--help");
+    const size_t version_line = help.find("--version");
+    CPPUNIT_ASSERT_EQUAL(help.find("Show this info") - help_line, help.find("Show version info") - version_line);
 }
 
 void
@@ -474,11 +495,1751 @@ ParserTests::testDefaultValues1()
     // CPPUNIT_ASSERT_EQUAL(string("42,43"), get<string>(parser.getArgument(OPT_ID_2).getDefaultValue()));
 
     cout << "\n-----\n";
-    ArgumentList_t list = parser.getArguments();
-    for (size_t i = 0, n = list.size(); i < n; ++i) {
-        cout << list[i].toString() << '\n';
-        if (i < n - 1)
-            cout << '\n';
-    }
+    cout << parser.getHelp();
     cout << "-----\n";
 }
+
+void
+ParserTests::testEnvFallback()
+{
+    const int REQ_ID_1 = 1;
+    const int OPT_ID_2 = 2;
+    const int SW_ID_3 = 3;
+
+    char env_threads[] = "APP_THREADS=8";
+    char env_ratio[] = "APP_RATIO=0.5";
+    char env_verbose[] = "APP_VERBOSE=yes";
+    char* envp[] = { env_threads, env_ratio, env_verbose, nullptr };
+
+    Parser parser;
+    parser.setEnvironment(envp);
+    parser.addArgument({ REQUIRED, REQ_ID_1, "t", "threads", "Number of threads", INTEGER_TYPE, 1 })->setEnvVar("APP_THREADS");
+    parser.addArgument({ OPTIONAL, OPT_ID_2, "r", "ratio", "Ratio", DOUBLE_TYPE, 1 })->setEnvVar("APP_RATIO");
+    parser.addArgument({ SWITCH, SW_ID_3, "v", "verbose", "Verbose output" })->setEnvVar("APP_VERBOSE");
+
+    ParsedArguments_t results;
+    results = parser.exec("--threads=4");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(false, parser.isMissingRequiredArgs());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), results.size());
+    CPPUNIT_ASSERT_EQUAL(REQ_ID_1, results[0].first);
+    CPPUNIT_ASSERT_EQUAL(4, get<int>(results[0].second));
+    CPPUNIT_ASSERT_EQUAL(ARGV_SOURCE, parser.getValueSource(REQ_ID_1));
+    CPPUNIT_ASSERT_EQUAL(OPT_ID_2, results[1].first);
+    CPPUNIT_ASSERT_EQUAL(0.5, get<double>(results[1].second));
+    CPPUNIT_ASSERT_EQUAL(ENV_SOURCE, parser.getValueSource(OPT_ID_2));
+    CPPUNIT_ASSERT_EQUAL(true, get<bool>(results[2].second));
+    CPPUNIT_ASSERT_EQUAL(ENV_SOURCE, parser.getValueSource(SW_ID_3));
+
+    // The environment satisfies a required argument.
+    results = parser.exec("");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(false, parser.isMissingRequiredArgs());
+    CPPUNIT_ASSERT_EQUAL(8, get<int>(results[0].second));
+    CPPUNIT_ASSERT_EQUAL(ENV_SOURCE, parser.getValueSource(REQ_ID_1));
+
+    // Environment values go through the same type checks.
+    char bad_threads[] = "APP_THREADS=eight";
+    envp[0] = bad_threads;
+    results = parser.exec("");
+    CPPUNIT_ASSERT_EQUAL(true, parser.error());
+    cout << __func__ << ": " << parser.getErrorMsg() << "\n";
+}
+
+void
+ParserTests::testConfigFile()
+{
+    const int OPT_ID_1 = 1;
+    const int OPT_ID_2 = 2;
+    const int OPT_ID_3 = 3;
+    const int SW_ID_4 = 4;
+
+    const string config_path = (filesystem::temp_directory_path() / "abeargs_test.conf").string();
+    {
+        ofstream config(config_path);
+        config << "# Generated config\n"
+               << "[main]\n"
+               << "name = \"from file\"\n"
+               << "threads=2\n"
+               << "ratio = 0.25\r\n"
+               << "verbose\n";
+    }
+
+    char env_threads[] = "APP_THREADS=8";
+    char* envp[] = { env_threads, nullptr };
+
+    Parser parser;
+    parser.setEnvironment(envp);
+    parser.addArgument({ OPTIONAL, OPT_ID_1, "n", "name", "Name", STRING_TYPE, 1 });
+    parser.addArgument({ OPTIONAL, OPT_ID_2, "t", "threads", "Number of threads", INTEGER_TYPE, 1 })->setEnvVar("APP_THREADS");
+    parser.addArgument({ OPTIONAL, OPT_ID_3, "r", "ratio", "Ratio", DOUBLE_TYPE, 1 });
+    parser.addArgument({ SWITCH, SW_ID_4, "v", "verbose", "Verbose output" });
+
+    CPPUNIT_ASSERT_EQUAL(true, parser.loadConfigFile(config_path));
+
+    // defaults < file < env < argv
+    ParsedArguments_t results;
+    results = parser.exec("--ratio=0.75");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(4), results.size());
+    CPPUNIT_ASSERT_EQUAL(OPT_ID_3, results[0].first);
+    CPPUNIT_ASSERT_EQUAL(0.75, get<double>(results[0].second));
+    CPPUNIT_ASSERT_EQUAL(ARGV_SOURCE, parser.getValueSource(OPT_ID_3));
+    CPPUNIT_ASSERT_EQUAL(OPT_ID_2, results[1].first);
+    CPPUNIT_ASSERT_EQUAL(8, get<int>(results[1].second));
+    CPPUNIT_ASSERT_EQUAL(ENV_SOURCE, parser.getValueSource(OPT_ID_2));
+    CPPUNIT_ASSERT_EQUAL(OPT_ID_1, results[2].first);
+    CPPUNIT_ASSERT_EQUAL(string("from file"), get<string>(results[2].second));
+    CPPUNIT_ASSERT_EQUAL(FILE_SOURCE, parser.getValueSource(OPT_ID_1));
+    CPPUNIT_ASSERT_EQUAL(true, get<bool>(results[3].second));
+    CPPUNIT_ASSERT_EQUAL(FILE_SOURCE, parser.getValueSource(SW_ID_4));
+
+    // Keys must name a registered long flag.
+    {
+        ofstream config(config_path);
+        config << "name=partial\nthreds=3\n";
+    }
+    CPPUNIT_ASSERT_EQUAL(false, parser.loadConfigFile(config_path));
+    cout << __func__ << ": " << parser.getErrorMsg() << "\n";
+
+    // A file that fails to load leaves the previous file's values in place.
+    results = parser.exec("");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(string("from file"), parser.getResults().get<string>(OPT_ID_1));
+
+    // A file that loads replaces them all.
+    {
+        ofstream config(config_path);
+        config << "[other]\nratio = 0.5\n";
+    }
+    CPPUNIT_ASSERT_EQUAL(true, parser.loadConfigFile(config_path));
+    results = parser.exec("");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(NO_ARG, parser.getValueSource(OPT_ID_1));
+    CPPUNIT_ASSERT_EQUAL(NO_ARG, parser.getValueSource(SW_ID_4));
+    CPPUNIT_ASSERT_EQUAL(FILE_SOURCE, parser.getValueSource(OPT_ID_3));
+
+    filesystem::remove(config_path);
+}
+
+void
+ParserTests::testCompiledSpec()
+{
+    const int REQ_ID_1 = 1;
+    const int OPT_ID_2 = 2;
+    const int SW_ID_3 = 3;
+    const int X_ID_4 = 4;
+
+    const string spec_path = (filesystem::temp_directory_path() / "abeargs_test.spec").string();
+    filesystem::remove(spec_path);
+
+    int build_count = 0;
+    auto build = [&build_count](Parser& p_parser) {
+        ++build_count;
+        p_parser.addArgument({ REQUIRED, REQ_ID_1, "1", "one", "Required argument 1", INTEGER_TYPE, 1 })->setDefaultValue(7);
+        p_parser.addArgument({ OPTIONAL, OPT_ID_2, "2", "two", "Optional argument 2", DOUBLE_TYPE, 2 });
+        p_parser.addArgument({ SWITCH, SW_ID_3, "s", "switch", "A switch" })->setFlagType(SLASH_FLAG);
+        p_parser.addArgument({ X_SWITCH, X_ID_4, "h", "help", "Show help" });
+    };
+
+    // A program keeps its table's key as a constant.
+    Parser built;
+    build(built);
+    const uint64_t SPEC_KEY = CompiledSpec::specKey(built);
+    CPPUNIT_ASSERT(SPEC_KEY != 0);
+    build_count = 0;
+
+    // The first run builds and writes the cache.
+    {
+        CompiledSpec spec;
+        CPPUNIT_ASSERT_EQUAL(true, spec.openOrBuild(spec_path, SPEC_KEY, build));
+        CPPUNIT_ASSERT_EQUAL(true, spec.wasRebuilt());
+    }
+
+    // The next run maps it.
+    CompiledSpec spec;
+    CPPUNIT_ASSERT_EQUAL(true, spec.openOrBuild(spec_path, SPEC_KEY, build));
+    CPPUNIT_ASSERT_EQUAL(false, spec.wasRebuilt());
+    CPPUNIT_ASSERT_EQUAL(1, build_count);
+    CPPUNIT_ASSERT_EQUAL(true, spec.verify());
+    CPPUNIT_ASSERT_EQUAL(size_t(4), spec.size());
+    CPPUNIT_ASSERT_EQUAL(2, spec.findFlag("/s"));
+    CPPUNIT_ASSERT_EQUAL(-1, spec.findFlag("-s"));
+    CPPUNIT_ASSERT_EQUAL(1, spec.findID(OPT_ID_2));
+    CPPUNIT_ASSERT_EQUAL(true, spec.isRequired(0));
+    CPPUNIT_ASSERT_EQUAL(true, spec.isXSwitch(3));
+    CPPUNIT_ASSERT_EQUAL(7, get<int>(spec.getArgument(0).getDefaultValue()));
+
+    Parser parser;
+    parser.setSpec(&spec);
+    // Only the required argument exists up front.
+    CPPUNIT_ASSERT_EQUAL(size_t(1), parser.getArguments().size());
+
+    ParsedArguments_t results;
+    results = parser.exec("--two=1.5,2.5 /s -1=10");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(false, parser.isMissingRequiredArgs());
+    CPPUNIT_ASSERT_EQUAL(OPT_ID_2, results[0].first);
+    CPPUNIT_ASSERT_EQUAL(string("1.5,2.5"), get<string>(results[0].second));
+    CPPUNIT_ASSERT_EQUAL(SW_ID_3, results[1].first);
+    CPPUNIT_ASSERT_EQUAL(10, get<int>(results[2].second));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), parser.getArguments().size());
+
+    results = parser.exec("--help");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(X_ID_4, results[0].first);
+
+    results = parser.exec("-s");
+    CPPUNIT_ASSERT_EQUAL(true, parser.error());
+
+    // Creating a spec's argument mid-parse rebuilds the suggestions; the ones
+    // already made are kept.
+    Parser collecting;
+    collecting.setSpec(&spec);
+    collecting.setCollectAllErrors(true);
+    collecting.exec("--twoo /s --hel");
+    CPPUNIT_ASSERT_EQUAL(size_t(2), collecting.getDiagnostics().size());
+    CPPUNIT_ASSERT_EQUAL(string("--two"), collecting.getDiagnostics()[0].suggestion);
+    CPPUNIT_ASSERT_EQUAL(string("--help"), collecting.getDiagnostics()[1].suggestion);
+
+    // A changed table has a new key, so its cache is rebuilt.
+    auto build_more = [&build](Parser& p_parser) {
+        build(p_parser);
+        p_parser.addArgument({ OPTIONAL, 5, "o", "out", "Output file", STRING_TYPE, 1 });
+    };
+    Parser built_more;
+    build_more(built_more);
+    const uint64_t MORE_KEY = CompiledSpec::specKey(built_more);
+    CPPUNIT_ASSERT(MORE_KEY != SPEC_KEY);
+    CompiledSpec rebuilt;
+    CPPUNIT_ASSERT_EQUAL(true, rebuilt.openOrBuild(spec_path, MORE_KEY, build_more));
+    CPPUNIT_ASSERT_EQUAL(true, rebuilt.wasRebuilt());
+    CPPUNIT_ASSERT_EQUAL(size_t(5), rebuilt.size());
+    CPPUNIT_ASSERT_EQUAL(3, build_count);
+
+    // A changed table with the old key is refused rather than cached, and
+    // the diagnostic has the key to use.
+    filesystem::remove(spec_path);
+    CompiledSpec forgotten;
+    CPPUNIT_ASSERT_EQUAL(false, forgotten.openOrBuild(spec_path, SPEC_KEY, build_more));
+    CPPUNIT_ASSERT_EQUAL(false, filesystem::exists(spec_path));
+    CPPUNIT_ASSERT_EQUAL(STALE_SPEC_KEY, forgotten.getDiagnostics()[0].code);
+    char key_text[24];
+    snprintf(key_text, sizeof(key_text), "0x%016llx", static_cast<unsigned long long>(MORE_KEY));
+    CPPUNIT_ASSERT_EQUAL(string(key_text), string(forgotten.getDiagnostics()[0].token));
+
+    // Damaged content isn't looked for when opening (that's the whole blob);
+    // verify() finds it, and writing the cache again repairs it.
+    CPPUNIT_ASSERT_EQUAL(true, CompiledSpec::write(built, spec_path));
+    {
+        fstream file(spec_path, ios::in | ios::out | ios::binary);
+        file.seekp(-1, ios::end);
+        file.put('?');
+    }
+    CompiledSpec damaged;
+    CPPUNIT_ASSERT_EQUAL(true, damaged.openOrBuild(spec_path, SPEC_KEY, build));
+    CPPUNIT_ASSERT_EQUAL(false, damaged.wasRebuilt());
+    CPPUNIT_ASSERT_EQUAL(false, damaged.verify());
+    CPPUNIT_ASSERT_EQUAL(true, CompiledSpec::write(built, spec_path));
+    CPPUNIT_ASSERT_EQUAL(true, damaged.open(spec_path, SPEC_KEY));
+    CPPUNIT_ASSERT_EQUAL(true, damaged.verify());
+
+    // A hand-edited section offset is refused. A hand-edited string offset
+    // is found when the record is read, and reads as empty.
+    const std::string blob = CompiledSpec::serialize(built);
+    CompiledSpec edited;
+    CPPUNIT_ASSERT_EQUAL(true, edited.assign(blob));
+
+    // The header's args_offset, then the first record's short name offset.
+    const size_t args_offset_at = 36;
+    uint32_t args_offset = 0;
+    memcpy(&args_offset, blob.data() + args_offset_at, sizeof(args_offset));
+    const uint32_t bad_offset = 0xfffffff0;
+    std::string bad_blob = blob;
+    memcpy(&bad_blob[args_offset_at], &bad_offset, sizeof(bad_offset));
+    CPPUNIT_ASSERT_EQUAL(false, edited.assign(bad_blob));
+
+    bad_blob = blob;
+    memcpy(&bad_blob[args_offset + 12], &bad_offset, sizeof(bad_offset));
+    CPPUNIT_ASSERT_EQUAL(true, edited.assign(bad_blob));
+    CPPUNIT_ASSERT_EQUAL(string(), edited.getArgument(0).getShortFlagName());
+    CPPUNIT_ASSERT_EQUAL(-1, edited.findFlag("-1"));
+    CPPUNIT_ASSERT_EQUAL(0, edited.findFlag("--one"));
+
+    // Choices, limits, counting, list order and the duplicate policy all
+    // survive the round trip.
+    Parser full;
+    full.addArgument({ OPTIONAL, 11, "m", "mode", "Mode", CHOICE_TYPE, 1 })->setChoices({ { "Fast", 1 }, { "safe", 2 } }, true);
+    full.addArgument({ OPTIONAL, 12, "t", "threads", "Threads", INTEGER_TYPE, 1 })->setRange(1, 8);
+    full.addArgument({ OPTIONAL, 13, "n", "name", "Name", STRING_TYPE, 1 })->setLengthLimits(2, 4);
+    full.addArgument({ SWITCH, 14, "v", "verbose", "Verbosity" })->setCountable();
+    full.addArgument({ OPTIONAL, 15, "i", "ids", "IDs", INTEGER_LIST_TYPE, 1 })->setListOrder(true, true);
+    full.addArgument({ OPTIONAL, 16, "o", "once", "Only once", STRING_TYPE, 1 })->setDuplicatePolicy(DUPLICATE_ERROR);
+
+    CompiledSpec full_spec;
+    CPPUNIT_ASSERT_EQUAL(true, full_spec.assign(CompiledSpec::serialize(full)));
+    Parser from_spec;
+    from_spec.setSpec(&full_spec);
+
+    from_spec.exec("--mode=FAST -t 4 -n abc -vvv -i 3,1,3");
+    CPPUNIT_ASSERT_EQUAL(false, from_spec.error());
+    Results values = from_spec.getResults();
+    CPPUNIT_ASSERT_EQUAL(1, values.get<int>(11));
+    CPPUNIT_ASSERT_EQUAL(3, values.get<int>(14));
+    CPPUNIT_ASSERT(IntList_t({ 1, 3 }) == values.get<IntList_t>(15));
+
+    from_spec.exec("--mode=slow");
+    CPPUNIT_ASSERT_EQUAL(INVALID_CHOICE, from_spec.getErrorCode());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("Fast, safe"), from_spec.getDiagnostics().front().allowed);
+    from_spec.exec("-t 9");
+    CPPUNIT_ASSERT_EQUAL(OUT_OF_RANGE, from_spec.getErrorCode());
+    from_spec.exec("-n abcde");
+    CPPUNIT_ASSERT_EQUAL(INVALID_LENGTH, from_spec.getErrorCode());
+
+    from_spec.exec("-o a -o b");
+    CPPUNIT_ASSERT_EQUAL(DUPLICATE_OPTION, from_spec.getErrorCode());
+
+    // A predicate or binding is code, so an argument with one can't be
+    // compiled, and each one is reported.
+    full.addArgument({ OPTIONAL, 17, "e", "even", "Even", INTEGER_TYPE, 1 })->addPredicate([](const VarValue_t& p_value) {
+        return get<int>(p_value) % 2 == 0;
+    });
+    int bound_count = 0;
+    full.addArgument({ OPTIONAL, 18, "c", "count", "Count", INTEGER_TYPE, 1 })->bind(&bound_count);
+    vector<Diagnostic> uncompilable;
+    CPPUNIT_ASSERT_EQUAL(true, CompiledSpec::serialize(full, &uncompilable).empty());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), uncompilable.size());
+    CPPUNIT_ASSERT_EQUAL(UNCOMPILABLE_ARGUMENT, uncompilable[0].code);
+    CPPUNIT_ASSERT_EQUAL(17, uncompilable[0].arg_ID);
+    CPPUNIT_ASSERT_EQUAL(string("even"), string(uncompilable[0].token));
+    CPPUNIT_ASSERT_EQUAL(string("count"), string(uncompilable[1].token));
+
+    filesystem::remove(spec_path);
+    CompiledSpec uncompiled;
+    CPPUNIT_ASSERT_EQUAL(false, uncompiled.openOrBuild(spec_path, SPEC_KEY, [&](Parser& p_parser) {
+        p_parser.addArgument({ OPTIONAL, 18, "c", "count", "Count", INTEGER_TYPE, 1 })->bind(&bound_count);
+    }));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), uncompiled.getDiagnostics().size());
+    CPPUNIT_ASSERT_EQUAL(
+      string("error: Can't compile an argument with a binding or predicate: count"),
+      uncompiled.getDiagnostics()[0].toString());
+
+    filesystem::remove(spec_path);
+}
+
+void
+ParserTests::testGeneratedParser()
+{
+    using namespace test_gen;
+
+    string error;
+    {
+        char arg0[] = "app", arg1[] = "--threads=8", arg2[] = "-v", arg3[] = "-1", arg4[] = "10", arg5[] = "--name=abe";
+        char* argv[] = { arg0, arg1, arg2, arg3, arg4, arg5 };
+        TestOptions options;
+        CPPUNIT_ASSERT_EQUAL(true, parse(6, argv, options, error));
+        CPPUNIT_ASSERT_EQUAL(8, options.threads);
+        CPPUNIT_ASSERT_EQUAL(true, options.verbose);
+        CPPUNIT_ASSERT_EQUAL(10, options.one);
+        CPPUNIT_ASSERT_EQUAL(string("abe"), options.name);
+        // Defaults come from the spec.
+        CPPUNIT_ASSERT_EQUAL(0.5, options.ratio);
+        CPPUNIT_ASSERT_EQUAL(false, options.has(TestOptions::RATIO_ID));
+        CPPUNIT_ASSERT_EQUAL(true, options.has(TestOptions::THREADS_ID));
+    }
+    {
+        char arg0[] = "app", arg1[] = "--threads=3.14";
+        char* argv[] = { arg0, arg1 };
+        TestOptions options;
+        CPPUNIT_ASSERT_EQUAL(false, parse(2, argv, options, error));
+        cout << __func__ << ": " << error << "\n";
+    }
+    {
+        char arg0[] = "app", arg1[] = "--help", arg2[] = "--bogus";
+        char* argv[] = { arg0, arg1, arg2 };
+        TestOptions options;
+        CPPUNIT_ASSERT_EQUAL(true, parse(3, argv, options, error));
+        CPPUNIT_ASSERT_EQUAL(true, options.help);
+    }
+    {
+        char arg0[] = "app", arg1[] = "-v";
+        char* argv[] = { arg0, arg1 };
+        TestOptions options;
+        CPPUNIT_ASSERT_EQUAL(false, parse(2, argv, options, error));
+        cout << __func__ << ": " << error << "\n";
+    }
+
+    cout << "\n-----\n" << HELP_TEXT << "-----\n";
+}
+
+void
+ParserTests::testDiagnostics()
+{
+    const int OPT_ID_1 = 1;
+    const int OPT_ID_2 = 2;
+
+    Parser parser;
+    parser.addArgument({ OPTIONAL, OPT_ID_1, "1", "one", "Optional argument 1", INTEGER_TYPE, 1 });
+    parser.addArgument({ OPTIONAL, OPT_ID_2, "2", "two", "Optional argument 2", DOUBLE_TYPE, 2 });
+
+    // By default the parse stops at the first error.
+    ParsedArguments_t results;
+    results = parser.exec("-1=x --bogus -2=1.5,2.5");
+    CPPUNIT_ASSERT_EQUAL(true, parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), parser.getDiagnostics().size());
+    CPPUNIT_ASSERT_EQUAL(INVALID_INTEGER, parser.getErrorCode());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), parser.getDiagnostics()[0].position);
+    CPPUNIT_ASSERT_EQUAL(string("x"), string(parser.getDiagnostics()[0].token));
+
+    // Collect every diagnostic in one pass.
+    parser.setCollectAllErrors(true);
+    results = parser.exec("-1=x --bogus -2=1.5,2.5 -2=3");
+    const vector<Diagnostic>& diagnostics = parser.getDiagnostics();
+    CPPUNIT_ASSERT_EQUAL(size_t(3), diagnostics.size());
+    CPPUNIT_ASSERT_EQUAL(INVALID_INTEGER, diagnostics[0].code);
+    CPPUNIT_ASSERT_EQUAL(UNRECOGNIZED_OPTION, diagnostics[1].code);
+    CPPUNIT_ASSERT_EQUAL(string("--bogus"), string(diagnostics[1].token));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), diagnostics[1].position);
+    CPPUNIT_ASSERT_EQUAL(WRONG_PARAM_COUNT, diagnostics[2].code);
+    CPPUNIT_ASSERT_EQUAL(OPT_ID_2, diagnostics[2].arg_ID);
+    // The valid argument between the errors is still parsed.
+    CPPUNIT_ASSERT_EQUAL(OPT_ID_2, results[0].first);
+    CPPUNIT_ASSERT_EQUAL(string("1.5,2.5"), get<string>(results[0].second));
+    cout << __func__ << ":\n" << parser.getErrorMsg() << "\n";
+
+    results = parser.exec("-1=7");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(NO_ERRORS, parser.getErrorCode());
+}
+
+void
+ParserTests::testArgumentStream()
+{
+    const int SWITCH_ID = 1;
+    const int OPT_ID = 2;
+    const int HELP_ID = 3;
+
+    // The tokenizer splits the same way as the replace/tokenize/join steps.
+    const string line = "-a=1,2 --name='John Smith' -x \"a=b, c\" [1,2] <file>";
+    const char pairs[] = { '\'', '\'', '"', '"', '(', ')', '[', ']', '{', '}', '<', '>' };
+    string replaced = line;
+    Util::replaceAll(replaced, '=', ' ', pairs, sizeof(pairs));
+    Util::replaceAll(replaced, ',', ' ', pairs, sizeof(pairs));
+    Util::StringList expected = Util::tokenize(replaced, ' ');
+    for (size_t i = 0; i < sizeof(pairs); i += 2)
+        expected = Util::joinDelimitedTokens(expected, pairs[i], pairs[i + 1], ' ');
+
+    Util::StringList tokens;
+    Tokenizer tokenizer(line);
+    string_view token;
+    while (tokenizer.next(token))
+        tokens.emplace_back(token);
+    CPPUNIT_ASSERT(expected == tokens);
+
+    // With a join buffer the same tokens are joined in the caller's bytes.
+    char bytes[64];
+    size_t used = 0;
+    tokens.clear();
+    tokenizer.reset(line);
+    tokenizer.setJoinBuffer(bytes);
+    while (tokenizer.next(token)) {
+        tokens.emplace_back(token);
+        used += tokenizer.getJoinedSize();
+        tokenizer.setJoinBuffer(std::span<char>(bytes).subspan(used));
+    }
+    CPPUNIT_ASSERT(expected == tokens);
+    CPPUNIT_ASSERT_EQUAL(false, tokenizer.joinOverflowed());
+    CPPUNIT_ASSERT_EQUAL(string_view("'John Smith'"), string_view(bytes, 12));
+    CPPUNIT_ASSERT_EQUAL('\0', bytes[12]);
+
+    // A block that doesn't fit ends the tokens.
+    tokenizer.reset(line);
+    tokenizer.setJoinBuffer(std::span<char>(bytes, 8));
+    while (tokenizer.next(token)) {
+    }
+    CPPUNIT_ASSERT_EQUAL(true, tokenizer.joinOverflowed());
+
+    Parser parser;
+    parser.addArgument({ SWITCH, SWITCH_ID, "s", "switch", "A switch" });
+    parser.addArgument({ OPTIONAL, OPT_ID, "o", "opt", "Optional argument", INTEGER_TYPE, 1 });
+    parser.addArgument({ X_SWITCH, HELP_ID, "h", "help", "Exclusive switch" });
+
+    // Results come out one at a time, in command line order.
+    pair<int, VarValue_t> result;
+    ArgumentStream stream(parser, "-s --opt=3 --bogus");
+    CPPUNIT_ASSERT(stream.next(result));
+    CPPUNIT_ASSERT_EQUAL(SWITCH_ID, result.first);
+    CPPUNIT_ASSERT(stream.next(result));
+    CPPUNIT_ASSERT_EQUAL(OPT_ID, result.first);
+    CPPUNIT_ASSERT_EQUAL(3, get<int>(result.second));
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    // The error ends the stream.
+    CPPUNIT_ASSERT(!stream.next(result));
+    CPPUNIT_ASSERT_EQUAL(UNRECOGNIZED_OPTION, parser.getErrorCode());
+
+    // An exclusive switch ends the stream without reading the rest.
+    ArgumentStream help(parser, "-h --opt=x --bogus");
+    CPPUNIT_ASSERT(help.next(result));
+    CPPUNIT_ASSERT_EQUAL(HELP_ID, result.first);
+    CPPUNIT_ASSERT(!help.next(result));
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(false, parser.hasArgvToken(OPT_ID));
+}
+
+void
+ParserTests::testShortFlagClusters()
+{
+    const int A_ID = 1;
+    const int B_ID = 2;
+    const int VERBOSE_ID = 3;
+    const int OUT_ID = 4;
+
+    Parser parser;
+    parser.addArgument({ SWITCH, A_ID, "a", "all", "Switch a" });
+    parser.addArgument({ SWITCH, B_ID, "b", "brief", "Switch b" });
+    parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbosity" })->setCountable();
+    parser.addArgument({ OPTIONAL, OUT_ID, "o", "out", "Output file", STRING_TYPE, 1 });
+
+    ParsedArguments_t results;
+    results = parser.exec("-ab -vvv -v --verbose -ofile.txt");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(4), results.size());
+    CPPUNIT_ASSERT_EQUAL(A_ID, results[0].first);
+    CPPUNIT_ASSERT_EQUAL(true, get<bool>(results[0].second));
+    CPPUNIT_ASSERT_EQUAL(B_ID, results[1].first);
+    CPPUNIT_ASSERT_EQUAL(VERBOSE_ID, results[2].first);
+    CPPUNIT_ASSERT_EQUAL(5, get<int>(results[2].second));
+    CPPUNIT_ASSERT_EQUAL(OUT_ID, results[3].first);
+    CPPUNIT_ASSERT_EQUAL(string("file.txt"), get<string>(results[3].second));
+
+    // A value-taking flag at the end of a cluster takes the next token.
+    results = parser.exec("-bo out.txt");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), results.size());
+    CPPUNIT_ASSERT_EQUAL(string("out.txt"), get<string>(results[1].second));
+
+    // An unknown flag rejects the whole cluster.
+    results = parser.exec("-abz");
+    CPPUNIT_ASSERT_EQUAL(true, parser.error());
+    CPPUNIT_ASSERT_EQUAL(UNRECOGNIZED_OPTION, parser.getErrorCode());
+    CPPUNIT_ASSERT_EQUAL(string("-abz"), string(parser.getDiagnostics()[0].token));
+    CPPUNIT_ASSERT_EQUAL(int(NO_ARG), results[0].first);
+}
+
+void
+ParserTests::testBoundArguments()
+{
+    const int COUNT_ID = 1;
+    const int NAME_ID = 2;
+    const int VERBOSE_ID = 3;
+    const int RATIO_ID = 4;
+    const int HELP_ID = 5;
+
+    struct Options
+    {
+        int verbose = 0;
+        double ratio = 0.5;
+    };
+
+    int count = 0;
+    string name = "none";
+
+    Parser parser;
+    parser.addArgument({ OPTIONAL, COUNT_ID, "c", "count", "A count", INTEGER_TYPE, 1 })->bind(&count);
+    parser.addArgument({ OPTIONAL, NAME_ID, "n", "name", "A name", STRING_TYPE, 1 })->bind(&name);
+    parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbosity" })->setCountable().bind(&Options::verbose);
+    parser.addArgument({ OPTIONAL, RATIO_ID, "r", "ratio", "A ratio", DOUBLE_TYPE, 1 })->bind(&Options::ratio);
+    parser.addArgument({ X_SWITCH, HELP_ID, "h", "help", "Show help" });
+
+    Options options;
+    CPPUNIT_ASSERT(parser.execInto("-c 3 --name='John Smith' -vv -r=0.25", options));
+    CPPUNIT_ASSERT_EQUAL(3, count);
+    CPPUNIT_ASSERT_EQUAL(string("John Smith"), name);
+    CPPUNIT_ASSERT_EQUAL(2, options.verbose);
+    CPPUNIT_ASSERT_EQUAL(0.25, options.ratio);
+
+    // Unbound arguments are only reported by their source.
+    CPPUNIT_ASSERT(parser.execInto("--help -c 7"));
+    CPPUNIT_ASSERT_EQUAL(ARGV_SOURCE, parser.getValueSource(HELP_ID));
+    CPPUNIT_ASSERT_EQUAL(3, count);
+
+    CPPUNIT_ASSERT(!parser.execInto("-c x"));
+    CPPUNIT_ASSERT_EQUAL(INVALID_INTEGER, parser.getErrorCode());
+}
+
+void
+ParserTests::testResultsView()
+{
+    const int FIRST_ID = 1;
+    const int LAST_ID = 2;
+    const int ONCE_ID = 3;
+    const int TAGS_ID = 4;
+    const int RATIO_ID = 5;
+    const int LEVELS_ID = 6;
+
+    Parser parser;
+    parser.addArgument({ OPTIONAL, FIRST_ID, "f", "first", "First wins", INTEGER_TYPE, 1 })->setDuplicatePolicy(FIRST_WINS);
+    parser.addArgument({ OPTIONAL, LAST_ID, "l", "last", "Last wins", INTEGER_TYPE, 1 });
+    parser.addArgument({ OPTIONAL, ONCE_ID, "o", "once", "Only once", STRING_TYPE, 1 })->setDuplicatePolicy(DUPLICATE_ERROR);
+    parser.addArgument({ OPTIONAL, TAGS_ID, "t", "tag", "Tags", STRING_TYPE, 1 })->setDuplicatePolicy(ACCUMULATE);
+    parser.addArgument({ OPTIONAL, RATIO_ID, "r", "ratio", "A ratio", DOUBLE_TYPE, 1 })->setDefaultValue(0.5);
+    parser.addArgument({ OPTIONAL, LEVELS_ID, "L", "level", "Levels", INTEGER_TYPE, 1 })->setDuplicatePolicy(ACCUMULATE);
+
+    parser.exec("-f 1 -f 2 -l 1 -l 2 -t a --tag=b -t c -L 3 -L 1 --level=2");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+
+    const Results results = parser.getResults();
+    CPPUNIT_ASSERT(results.has(FIRST_ID));
+    CPPUNIT_ASSERT_EQUAL(1, results.get<int>(FIRST_ID));
+    CPPUNIT_ASSERT_EQUAL(2, results.get<int>(LAST_ID));
+    CPPUNIT_ASSERT_EQUAL(string("a,b,c"), results.get<string>(TAGS_ID));
+    // Integers accumulate into a list.
+    CPPUNIT_ASSERT(IntList_t({ 3, 1, 2 }) == results.get<IntList_t>(LEVELS_ID));
+
+    // A missing argument falls back to its default.
+    CPPUNIT_ASSERT(!results.has(RATIO_ID));
+    CPPUNIT_ASSERT_EQUAL(0.5, results.get<double>(RATIO_ID));
+    CPPUNIT_ASSERT_EQUAL(DEFAULT_SOURCE, results.getSource(RATIO_ID));
+    CPPUNIT_ASSERT(!results.has(ONCE_ID));
+    CPPUNIT_ASSERT_EQUAL(string(), results.get<string>(ONCE_ID));
+
+    // The view follows the next exec.
+    parser.exec("-o x -r 2 -o y");
+    CPPUNIT_ASSERT_EQUAL(true, parser.error());
+    CPPUNIT_ASSERT_EQUAL(DUPLICATE_OPTION, parser.getErrorCode());
+    CPPUNIT_ASSERT_EQUAL(size_t(4), parser.getDiagnostics()[0].position);
+    CPPUNIT_ASSERT_EQUAL(string("x"), results.get<string>(ONCE_ID));
+    CPPUNIT_ASSERT_EQUAL(2.0, results.get<double>(RATIO_ID));
+    CPPUNIT_ASSERT(!results.has(FIRST_ID));
+
+    // An accumulated integer given once is a list too, so it reads the same way.
+    parser.exec("-L 4");
+    CPPUNIT_ASSERT(IntList_t({ 4 }) == results.get<IntList_t>(LEVELS_ID));
+
+    // A double has no list to accumulate into, so it keeps its policy.
+    CPPUNIT_ASSERT_EQUAL(LAST_WINS, parser.getArgument(RATIO_ID).setDuplicatePolicy(ACCUMULATE).getDuplicatePolicy());
+}
+
+void
+ParserTests::testChoiceType()
+{
+    const int MODE_ID = 1;
+    const int CODEC_ID = 2;
+
+    enum Mode
+    {
+        FAST = 10,
+        SAFE,
+        AUDIT
+    };
+
+    // Enough codecs that the table needs a real seed search.
+    vector<Choice_t> codecs;
+    for (int i = 0; i < 48; ++i)
+        codecs.push_back({ "codec" + to_string(i), i });
+
+    Parser parser;
+    parser.addArgument({ OPTIONAL, MODE_ID, "m", "mode", "Mode", CHOICE_TYPE, 1 })
+      ->setChoices({ { "fast", FAST }, { "safe", SAFE }, { "audit", AUDIT } });
+    parser.addArgument({ OPTIONAL, CODEC_ID, "c", "codec", "Codec", CHOICE_TYPE, 1 })->setChoices(codecs, true);
+
+    ParsedArguments_t results;
+    results = parser.exec("--mode=audit -c CODEC47");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(AUDIT), get<int>(results[0].second));
+    CPPUNIT_ASSERT_EQUAL(47, get<int>(results[1].second));
+
+    for (int i = 0; i < 48; ++i) {
+        int value = -1;
+        CPPUNIT_ASSERT(parser.getArgument(CODEC_ID).getChoices()->find("Codec" + to_string(i), value));
+        CPPUNIT_ASSERT_EQUAL(i, value);
+    }
+
+    // Matching is case sensitive unless asked otherwise.
+    results = parser.exec("--mode=Fast");
+    CPPUNIT_ASSERT_EQUAL(true, parser.error());
+    CPPUNIT_ASSERT_EQUAL(INVALID_CHOICE, parser.getErrorCode());
+    CPPUNIT_ASSERT_EQUAL(string("error: Invalid choice: Fast (expected one of: fast, safe, audit)"), parser.getErrorMsg());
+}
+
+void
+ParserTests::testValidators()
+{
+    const int THREADS_ID = 1;
+    const int RATIO_ID = 2;
+    const int NAME_ID = 3;
+    const int EVEN_ID = 4;
+
+    Parser parser;
+    parser.addArgument({ OPTIONAL, THREADS_ID, "t", "threads", "Threads", INTEGER_TYPE, 1 })->setRange(1, 256);
+    parser.addArgument({ OPTIONAL, RATIO_ID, "r", "ratio", "Ratio", DOUBLE_TYPE, 1 })->addInterval({ 0.0, 1.0, true, false });
+    parser.addArgument({ OPTIONAL, NAME_ID, "n", "name", "Name", STRING_TYPE, 1 })->setLengthLimits(1, 8);
+    parser.addArgument({ OPTIONAL, EVEN_ID, "e", "even", "Even numbers", INTEGER_TYPE, 2 })->addPredicate([](const VarValue_t& p_value) {
+        return get<int>(p_value) % 2 == 0;
+    });
+
+    ParsedArguments_t results;
+    results = parser.exec("-t 256 -r 1 -n abc -e 2,4");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(4), results.size());
+
+    parser.setCollectAllErrors(true);
+    results = parser.exec("-t 0 -r 0 -n longer_than_8 -e 2,3");
+    const vector<Diagnostic>& diagnostics = parser.getDiagnostics();
+    CPPUNIT_ASSERT_EQUAL(size_t(4), diagnostics.size());
+    CPPUNIT_ASSERT_EQUAL(OUT_OF_RANGE, diagnostics[0].code);
+    CPPUNIT_ASSERT_EQUAL(string("error: Value out of range: 0 (expected [1, 256])"), diagnostics[0].toString());
+    CPPUNIT_ASSERT_EQUAL(OUT_OF_RANGE, diagnostics[1].code);
+    CPPUNIT_ASSERT_EQUAL(string("(0, 1]"), string(diagnostics[1].allowed));
+    CPPUNIT_ASSERT_EQUAL(INVALID_LENGTH, diagnostics[2].code);
+    CPPUNIT_ASSERT_EQUAL(string("1 to 8 characters"), string(diagnostics[2].allowed));
+    CPPUNIT_ASSERT_EQUAL(FAILED_CHECK, diagnostics[3].code);
+    CPPUNIT_ASSERT_EQUAL(string("3"), string(diagnostics[3].token));
+}
+
+void
+ParserTests::testIntegerList()
+{
+    const int IDS_ID = 1;
+    const int SHARDS_ID = 2;
+    const int NAME_ID = 3;
+
+    Parser parser;
+    parser.addArgument({ OPTIONAL, IDS_ID, "i", "ids", "IDs", INTEGER_LIST_TYPE, 1 })->setListOrder(false, true);
+    parser.addArgument({ OPTIONAL, SHARDS_ID, "s", "shards", "Shards", INTEGER_LIST_TYPE, 1 })->setListOrder(true, false).setRange(0, 4095);
+    parser.addArgument({ OPTIONAL, NAME_ID, "n", "name", "Name", STRING_TYPE, 1 });
+
+    ParsedArguments_t results;
+    results = parser.exec("--ids=12345678901,3 -n x");
+    CPPUNIT_ASSERT_EQUAL(true, parser.error());
+    CPPUNIT_ASSERT_EQUAL(INVALID_INTEGER, parser.getErrorCode());
+
+    results = parser.exec("--ids=1234567890,-7,3,1234567890,3 --shards 2048-2050,0-6:3 -n x");
+    CPPUNIT_ASSERT_EQUAL(false, parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), results.size());
+    CPPUNIT_ASSERT(IntList_t({ 1234567890, -7, 3 }) == get<IntList_t>(results[0].second));
+    CPPUNIT_ASSERT(IntList_t({ 0, 3, 6, 2048, 2049, 2050 }) == get<IntList_t>(results[1].second));
+    CPPUNIT_ASSERT_EQUAL(string("x"), get<string>(results[2].second));
+
+    // A long list, a descending range and the range limit.
+    IntList_t list;
+    string text;
+    for (int i = 0; i < 100000; ++i)
+        text += to_string(i * 37) + ",";
+    text += "10-1:3";
+    CPPUNIT_ASSERT(parseIntegerList(text, list));
+    CPPUNIT_ASSERT_EQUAL(size_t(100004), list.size());
+    CPPUNIT_ASSERT_EQUAL(99999 * 37, list[99999]);
+    CPPUNIT_ASSERT_EQUAL(1, list.back());
+    CPPUNIT_ASSERT(!parseIntegerList("0-2147483647", list));
+    CPPUNIT_ASSERT(!parseIntegerList("1,,2", list));
+
+    results = parser.exec("-s 4000-4100");
+    CPPUNIT_ASSERT_EQUAL(OUT_OF_RANGE, parser.getErrorCode());
+}
+
+#if defined(__linux__) && defined(ABEARGS_LIBRARY_FILE)
+// The total size of the .init_array and .ctors sections of an ELF object.
+static size_t
+initArraySize(const char* p_object, size_t p_size)
+{
+    if (p_size < sizeof(Elf64_Ehdr) || memcmp(p_object, ELFMAG, SELFMAG) != 0 || p_object[EI_CLASS] != ELFCLASS64)
+        return 0;
+
+    Elf64_Ehdr header;
+    memcpy(&header, p_object, sizeof(header));
+    if (header.e_shoff == 0 || header.e_shstrndx >= header.e_shnum)
+        return 0;
+
+    auto section = [&](size_t p_index) {
+        Elf64_Shdr shdr;
+        memcpy(&shdr, p_object + header.e_shoff + p_index * sizeof(shdr), sizeof(shdr));
+        return shdr;
+    };
+
+    const Elf64_Shdr names = section(header.e_shstrndx);
+    size_t total = 0;
+    for (size_t i = 0; i < header.e_shnum; ++i) {
+        const Elf64_Shdr shdr = section(i);
+        const char* name = p_object + names.sh_offset + shdr.sh_name;
+        if (strcmp(name, ".init_array") == 0 || strncmp(name, ".init_array.", 12) == 0 || strcmp(name, ".ctors") == 0)
+            total += shdr.sh_size;
+    }
+    return total;
+}
+#endif
+
+void
+ParserTests::testNoStaticInitializers()
+{
+    // The defaults are constant expressions.
+    static_assert(DEFAULT_LONG_DASH_CHARS == "--");
+    static_assert(DEFAULT_SHORT_FLAG_NAME.size() == 18);
+
+#if defined(__linux__) && defined(ABEARGS_LIBRARY_FILE)
+    ifstream file(ABEARGS_LIBRARY_FILE, ios::binary);
+    CPPUNIT_ASSERT(file.good());
+    const string data{ istreambuf_iterator<char>(file), istreambuf_iterator<char>() };
+
+    size_t init_size = 0;
+    size_t num_objects = 0;
+    if (data.compare(0, SARMAG, ARMAG) == 0) {
+        // A static library: walk the archive's members.
+        for (size_t pos = SARMAG; pos + 60 <= data.size();) {
+            const size_t member_size = stoul(data.substr(pos + 48, 10));
+            const char* member = data.data() + pos + 60;
+            if (memcmp(member, ELFMAG, SELFMAG) == 0) {
+                init_size += initArraySize(member, member_size);
+                ++num_objects;
+            }
+            pos += 60 + member_size + (member_size % 2);
+        }
+    } else {
+        init_size = initArraySize(data.data(), data.size());
+        num_objects = 1;
+    }
+
+    CPPUNIT_ASSERT(num_objects > 0);
+    // Nothing in the library runs before main().
+    CPPUNIT_ASSERT_EQUAL(size_t(0), init_size);
+#endif
+}
+
+// The prefix is stripped once with the parser's flag style and the names are compared bare.
+static constexpr bool
+stripsTo(std::string_view p_token, std::string_view p_name, bool p_is_short, bool p_is_long)
+{
+    FlagName flag;
+    return AnyStyle::strip(p_token, flag) && flag.name == p_name && flag.is_short == p_is_short && flag.is_long == p_is_long;
+}
+
+void
+ParserTests::testFlagStyles()
+{
+    static_assert(stripsTo("-v", "v", true, false));
+    static_assert(stripsTo("--verbose", "verbose", false, true));
+    static_assert(stripsTo("/v", "v", true, true));
+    static_assert(!stripsTo("v", "v", true, false));
+
+    const int VERBOSE_ID = 1;
+    const int SLASH_ID = 2;
+    const int LEVEL_ID = 3;
+    const int OUTPUT_ID = 4;
+
+    // Dashes only.
+    Parser dash_parser;
+    dash_parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" });
+    dash_parser.addArgument({ OPTIONAL, LEVEL_ID, "lv", "level", "The level", INTEGER_TYPE, 1 });
+
+    ParsedArguments_t results = dash_parser.exec("--verbose -lv 3");
+    CPPUNIT_ASSERT(!dash_parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), results.size());
+    CPPUNIT_ASSERT_EQUAL(3, std::get<int>(results[1].second));
+
+    dash_parser.exec("/verbose");
+    CPPUNIT_ASSERT_EQUAL(UNRECOGNIZED_OPTION, dash_parser.getErrorCode());
+    dash_parser.exec("-verbose");
+    CPPUNIT_ASSERT_EQUAL(UNRECOGNIZED_OPTION, dash_parser.getErrorCode());
+
+    // Slashes only: a short and a long name share the prefix.
+    Parser slash_parser;
+    slash_parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" })->setFlagType(SLASH_FLAG);
+    slash_parser.addArgument({ OPTIONAL, OUTPUT_ID, "o", "out", "Output file", STRING_TYPE, 1 })->setFlagType(SLASH_FLAG);
+
+    results = slash_parser.exec("/v /out=a.txt");
+    CPPUNIT_ASSERT(!slash_parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), results.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("a.txt"), std::get<std::string>(results[1].second));
+
+    slash_parser.exec("--verbose");
+    CPPUNIT_ASSERT_EQUAL(UNRECOGNIZED_OPTION, slash_parser.getErrorCode());
+
+    // Both, with the same name for a dash and a slash flag.
+    Parser mixed_parser;
+    mixed_parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" });
+    mixed_parser.addArgument({ SWITCH, SLASH_ID, "v", "version", "Show the version" })->setFlagType(SLASH_FLAG);
+
+    results = mixed_parser.exec("-v /v");
+    CPPUNIT_ASSERT(!mixed_parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), results.size());
+    CPPUNIT_ASSERT_EQUAL(VERBOSE_ID, results[0].first);
+    CPPUNIT_ASSERT_EQUAL(SLASH_ID, results[1].first);
+    CPPUNIT_ASSERT_EQUAL(SLASH_ID, mixed_parser.getArgument("/version").getID());
+    CPPUNIT_ASSERT(mixed_parser.getArgument("/verbose").getID() == NO_ARG);
+
+    // The matching doesn't build the flags.
+    const Argument& verbose = mixed_parser.getArgument(VERBOSE_ID);
+    CPPUNIT_ASSERT(verbose.matchesFlag("--verbose"));
+    CPPUNIT_ASSERT(verbose.matchesFlag("-v"));
+    CPPUNIT_ASSERT(!verbose.matchesFlag("--v"));
+    CPPUNIT_ASSERT(!verbose.matchesFlag("/verbose"));
+}
+
+void
+ParserTests::testIgnoreFlagCase()
+{
+    const int VERBOSE_ID = 1;
+    const int OUTPUT_ID = 2;
+    const int LONG_ID = 3;
+    const std::string long_name(200, 'x');
+
+    Parser parser;
+    parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" })->setFlagType(SLASH_FLAG);
+    parser.addArgument({ OPTIONAL, OUTPUT_ID, "o", "OutputDirectory", "Output directory", STRING_TYPE, 1 })->setFlagType(SLASH_FLAG);
+    parser.addArgument({ SWITCH, LONG_ID, "L", long_name, "A long name" });
+
+    // Case sensitive by default.
+    parser.exec("/VERBOSE");
+    CPPUNIT_ASSERT_EQUAL(UNRECOGNIZED_OPTION, parser.getErrorCode());
+
+    parser.setIgnoreFlagCase(true);
+    ParsedArguments_t results = parser.exec("/VERBOSE /outputdirectory=Out/Dir");
+    CPPUNIT_ASSERT(!parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), results.size());
+    CPPUNIT_ASSERT_EQUAL(VERBOSE_ID, results[0].first);
+    // Only the flags are folded, not the values.
+    CPPUNIT_ASSERT_EQUAL(std::string("Out/Dir"), std::get<std::string>(results[1].second));
+
+    results = parser.exec("/V /O Out --" + std::string(200, 'X'));
+    CPPUNIT_ASSERT(!parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), results.size());
+    CPPUNIT_ASSERT_EQUAL(LONG_ID, results[2].first);
+    CPPUNIT_ASSERT_EQUAL(OUTPUT_ID, parser.getArgument("/OUTPUTDIRECTORY").getID());
+    CPPUNIT_ASSERT_EQUAL(LONG_ID, parser.getArgument("-l").getID());
+
+    parser.setIgnoreFlagCase(false);
+    CPPUNIT_ASSERT(parser.getArgument("/OUTPUTDIRECTORY").getID() == NO_ARG);
+    CPPUNIT_ASSERT_EQUAL(OUTPUT_ID, parser.getArgument("/OutputDirectory").getID());
+
+    // The eight at a time fold leaves everything but A-Z alone.
+    const std::string mixed = "ABC-xyz_@[`{Z\xc3\x84Q09";
+    std::string folded(mixed.size(), ' ');
+    Util::foldCase(mixed, folded.data());
+    CPPUNIT_ASSERT_EQUAL(std::string("abc-xyz_@[`{z\xc3\x84q09"), folded);
+}
+
+void
+ParserTests::testArgvOccurrences()
+{
+    const int VERBOSE_ID = 1;
+    const int OUTPUT_ID = 2;
+    const int QUIET_ID = 3;
+
+    Parser parser;
+    parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" })->setCountable(true);
+    parser.addArgument({ OPTIONAL, OUTPUT_ID, "o", "output", "Output file", STRING_TYPE, 1 });
+    parser.addArgument({ SWITCH, QUIET_ID, "q", "quiet", "No output" });
+
+    // Positions: 0 -v, 1 --output, 2 -v (the value), 3 -vv, 4 -o, 5 b.
+    parser.exec("-v --output -v -vv -o b");
+    CPPUNIT_ASSERT(!parser.error());
+
+    CPPUNIT_ASSERT(parser.hasArgvToken(VERBOSE_ID));
+    CPPUNIT_ASSERT_EQUAL(size_t(3), parser.getArgvCount(VERBOSE_ID));
+    CPPUNIT_ASSERT(parser.getArgvPositions(VERBOSE_ID) == std::vector<size_t>({ 0, 3, 3 }));
+
+    CPPUNIT_ASSERT_EQUAL(size_t(2), parser.getArgvCount(OUTPUT_ID));
+    CPPUNIT_ASSERT(parser.getArgvPositions(OUTPUT_ID) == std::vector<size_t>({ 1, 4 }));
+
+    CPPUNIT_ASSERT(!parser.hasArgvToken(QUIET_ID));
+    CPPUNIT_ASSERT(parser.getArgvPositions(QUIET_ID).empty());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), parser.getArgvCount(99));
+
+    // The index starts over with each parse.
+    parser.exec("-q");
+    CPPUNIT_ASSERT(!parser.hasArgvToken(VERBOSE_ID));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), parser.getArgvCount(QUIET_ID));
+}
+
+void
+ParserTests::testMapArguments()
+{
+    const int DEFINE_ID = 1;
+    const int SET_ID = 2;
+    const int VERBOSE_ID = 3;
+
+    Parser parser;
+    parser.addArgument({ OPTIONAL, DEFINE_ID, "D", "define", "Define a macro", MAP_TYPE, 1 });
+    parser.addArgument({ OPTIONAL, SET_ID, "s", "set", "Set a value", MAP_TYPE, 1 })->setDuplicatePolicy(DUPLICATE_ERROR);
+    parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" });
+
+    ParsedArguments_t results =
+        parser.exec("-DNAME=VALUE -D NDEBUG --define=LEVEL=2 -vDPATH=a=b --set key=value -DNAME=OTHER");
+    CPPUNIT_ASSERT(!parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), results.size());
+    // The result is the number of entries.
+    CPPUNIT_ASSERT_EQUAL(DEFINE_ID, results[0].first);
+    CPPUNIT_ASSERT_EQUAL(4, std::get<int>(results[0].second));
+
+    const ValueMap& defines = parser.getValueMap(DEFINE_ID);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), defines.size());
+    // The last value wins, and the entries keep the order they were first given in.
+    CPPUNIT_ASSERT(*defines.find("NAME") == "OTHER");
+    CPPUNIT_ASSERT(defines.find("NDEBUG")->empty());
+    CPPUNIT_ASSERT(*defines.find("LEVEL") == "2");
+    CPPUNIT_ASSERT(*defines.find("PATH") == "a=b");
+    CPPUNIT_ASSERT(defines.find("MISSING") == nullptr);
+    CPPUNIT_ASSERT(defines.getEntries()[1].key == "NDEBUG");
+
+    CPPUNIT_ASSERT(*parser.getValueMap(SET_ID).find("key") == "value");
+    CPPUNIT_ASSERT(parser.getValueMap(VERBOSE_ID).empty());
+
+    parser.exec("--set a=1 --set a=2");
+    CPPUNIT_ASSERT_EQUAL(DUPLICATE_KEY, parser.getErrorCode());
+    CPPUNIT_ASSERT(parser.getDiagnostics()[0].token == "a");
+    CPPUNIT_ASSERT_EQUAL(size_t(3), parser.getDiagnostics()[0].position);
+
+    // Thousands of entries grow the table without losing any.
+    std::string argv;
+    for (int i = 0; i < 5000; ++i)
+        argv += "-DK" + std::to_string(i) + "=" + std::to_string(i * 2) + " ";
+    parser.exec(argv);
+    CPPUNIT_ASSERT(!parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(5000), parser.getValueMap(DEFINE_ID).size());
+    CPPUNIT_ASSERT(*parser.getValueMap(DEFINE_ID).find("K4321") == "8642");
+    CPPUNIT_ASSERT(parser.getValueMap(SET_ID).empty());
+}
+
+void
+ParserTests::testPositionalArguments()
+{
+    const int VERBOSE_ID = 1;
+    const int MODE_ID = 2;
+    const int SIZE_ID = 3;
+    const int FILES_ID = 4;
+
+    Parser parser;
+    parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" });
+    parser.addArgument({ POSITIONAL, MODE_ID, "", "mode", "The mode" });
+    parser.addArgument({ POSITIONAL, SIZE_ID, "", "size", "Width and height", INTEGER_TYPE, 2 });
+    parser.addArgument({ VARIADIC, FILES_ID, "", "files", "Files to process" });
+
+    // From argv, the variadic arguments are the caller's own argv.
+    char arg0[] = "tool", arg1[] = "-v", arg2[] = "fast", arg3[] = "640", arg4[] = "480";
+    char arg5[] = "a.txt", arg6[] = "-x", arg7[] = "key=value,b.txt";
+    char* argv[] = { arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7 };
+
+    ParsedArguments_t results = parser.exec(8, argv);
+    CPPUNIT_ASSERT(!parser.error());
+    CPPUNIT_ASSERT(!parser.isMissingRequiredArgs());
+    CPPUNIT_ASSERT_EQUAL(size_t(4), results.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("fast"), std::get<std::string>(results[1].second));
+    CPPUNIT_ASSERT_EQUAL(std::string("640,480"), std::get<std::string>(results[2].second));
+    CPPUNIT_ASSERT_EQUAL(FILES_ID, results[3].first);
+    CPPUNIT_ASSERT_EQUAL(3, std::get<int>(results[3].second));
+
+    // Flags after the first variadic argument are passed along untouched.
+    std::span<char* const> files = parser.getVariadicArgs();
+    CPPUNIT_ASSERT_EQUAL(size_t(3), files.size());
+    CPPUNIT_ASSERT(files.data() == &argv[5]);
+    CPPUNIT_ASSERT_EQUAL(std::string("key=value,b.txt"), std::string(files[2]));
+
+    // From a string, the rest of the words are stored (a lone dash is positional).
+    results = parser.exec("slow 1 2 - -v");
+    CPPUNIT_ASSERT(!parser.error());
+    files = parser.getVariadicArgs();
+    CPPUNIT_ASSERT_EQUAL(size_t(2), files.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("-"), std::string(files[0]));
+    CPPUNIT_ASSERT_EQUAL(std::string("-v"), std::string(files[1]));
+    CPPUNIT_ASSERT(!parser.getResults().has(VERBOSE_ID));
+
+    // Positional arguments are required, and their values are converted.
+    parser.exec("-v slow");
+    CPPUNIT_ASSERT(parser.isMissingRequiredArgs());
+    CPPUNIT_ASSERT(parser.getVariadicArgs().empty());
+
+    parser.exec("slow 1 two");
+    CPPUNIT_ASSERT_EQUAL(INVALID_INTEGER, parser.getErrorCode());
+
+    // Without a variadic argument, extra tokens aren't recognized.
+    Parser strict_parser;
+    strict_parser.addArgument({ POSITIONAL, MODE_ID, "", "mode", "The mode" });
+    strict_parser.exec("fast extra");
+    CPPUNIT_ASSERT_EQUAL(UNRECOGNIZED_OPTION, strict_parser.getErrorCode());
+    strict_parser.exec("-mode");
+    CPPUNIT_ASSERT_EQUAL(UNRECOGNIZED_OPTION, strict_parser.getErrorCode());
+}
+
+void
+ParserTests::testPassthroughArguments()
+{
+    const int VERBOSE_ID = 1;
+    const int TIMEOUT_ID = 2;
+
+    Parser parser;
+    parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" });
+    parser.addArgument({ OPTIONAL, TIMEOUT_ID, "t", "timeout", "Timeout", INTEGER_TYPE, 1 });
+
+    // Everything after "--" is the caller's argv, untouched and ready for execv().
+    char arg0[] = "runner", arg1[] = "-t=5", arg2[] = "--", arg3[] = "grep", arg4[] = "-v", arg5[] = "a=b,c";
+    char* argv[] = { arg0, arg1, arg2, arg3, arg4, arg5, nullptr };
+
+    ParsedArguments_t results = parser.exec(6, argv);
+    CPPUNIT_ASSERT(!parser.error());
+    CPPUNIT_ASSERT_EQUAL(size_t(1), results.size());
+    CPPUNIT_ASSERT_EQUAL(5, std::get<int>(results[0].second));
+
+    std::span<char* const> child = parser.getPassthroughArgs();
+    CPPUNIT_ASSERT_EQUAL(size_t(3), child.size());
+    CPPUNIT_ASSERT(child.data() == &argv[3]);
+    CPPUNIT_ASSERT(child.data()[child.size()] == nullptr);
+    CPPUNIT_ASSERT(!parser.hasArgvToken(VERBOSE_ID));
+
+    // From a string, the words are stored as they are.
+    parser.exec("-v -- sh -c a=b,c");
+    CPPUNIT_ASSERT(!parser.error());
+    CPPUNIT_ASSERT(parser.hasArgvToken(VERBOSE_ID));
+    child = parser.getPassthroughArgs();
+    CPPUNIT_ASSERT_EQUAL(size_t(3), child.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("a=b,c"), std::string(child[2]));
+    CPPUNIT_ASSERT(child.data()[child.size()] == nullptr);
+
+    // Nothing after it, or no "--" at all.
+    char* end_argv[] = { arg0, arg2, nullptr };
+    parser.exec(2, end_argv);
+    CPPUNIT_ASSERT(parser.getPassthroughArgs().empty());
+    CPPUNIT_ASSERT(parser.getPassthroughArgs().data()[0] == nullptr);
+
+    parser.exec("-v");
+    CPPUNIT_ASSERT(parser.getPassthroughArgs().empty());
+}
+
+// Count the heap allocations made by each thread. The tests measure their
+// own thread, and the OptionsStore readers allocate at the same time.
+static thread_local size_t s_allocations = 0;
+
+void*
+operator new(size_t p_size)
+{
+    ++s_allocations;
+    if (void* memory = malloc(p_size == 0 ? 1 : p_size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void*
+operator new[](size_t p_size)
+{
+    return operator new(p_size);
+}
+
+void
+operator delete(void* p_memory) noexcept
+{
+    free(p_memory);
+}
+
+void
+operator delete[](void* p_memory) noexcept
+{
+    free(p_memory);
+}
+
+void
+operator delete(void* p_memory, size_t) noexcept
+{
+    free(p_memory);
+}
+
+void
+operator delete[](void* p_memory, size_t) noexcept
+{
+    free(p_memory);
+}
+
+void
+ParserTests::testParseContext()
+{
+    const int VERBOSE_ID = 1;
+    const int COUNT_ID = 2;
+    const int NAME_ID = 3;
+    const int RATIO_ID = 4;
+
+    Parser parser;
+    parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" });
+    parser.addArgument({ OPTIONAL, COUNT_ID, "c", "count", "Count", INTEGER_TYPE, 1 });
+    parser.addArgument({ OPTIONAL, NAME_ID, "n", "name", "Name", STRING_TYPE, 1 });
+    parser.addArgument({ OPTIONAL, RATIO_ID, "r", "ratio", "Ratio", DOUBLE_TYPE, 1 });
+
+    // Strings longer than the small string buffer, so they'd allocate if not reused.
+    const std::string_view lines[] = {
+        "-v --count=42 --name=a_name_longer_than_sso -r 0.5",
+        "--name=another_long_name_too -c 7",
+        "-v -n short",
+    };
+
+    ParseContext context;
+    for (int warm_up = 0; warm_up < 3; ++warm_up) {
+        for (std::string_view line : lines)
+            parser.exec(line, context);
+    }
+
+    // The asserts allocate, so only check the outcome afterwards.
+    const size_t allocations = s_allocations;
+    size_t failures = 0;
+    for (int repeat = 0; repeat < 100; ++repeat) {
+        for (std::string_view line : lines) {
+            if (!parser.exec(line, context))
+                ++failures;
+        }
+    }
+    const size_t parse_allocations = s_allocations - allocations;
+    CPPUNIT_ASSERT_EQUAL(size_t(0), failures);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), parse_allocations);
+
+    // The values of the last parse are in the parser.
+    CPPUNIT_ASSERT(parser.exec(lines[0], context));
+    Results results = parser.getResults();
+    CPPUNIT_ASSERT(results.has(VERBOSE_ID));
+    CPPUNIT_ASSERT_EQUAL(42, results.get<int>(COUNT_ID));
+    CPPUNIT_ASSERT_EQUAL(std::string("a_name_longer_than_sso"), results.get<std::string>(NAME_ID));
+    CPPUNIT_ASSERT_EQUAL(0.5, results.get<double>(RATIO_ID));
+
+    CPPUNIT_ASSERT(parser.exec(lines[2], context));
+    CPPUNIT_ASSERT(!parser.getResults().has(COUNT_ID));
+    CPPUNIT_ASSERT_EQUAL(std::string("short"), parser.getResults().get<std::string>(NAME_ID));
+}
+
+void
+ParserTests::testLineDispatcher()
+{
+#ifndef _WIN32
+    const int VERBOSE_ID = 1;
+    const int COUNT_ID = 2;
+    const int NAME_ID = 3;
+
+    Parser parser;
+    parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" });
+    parser.addArgument({ OPTIONAL, COUNT_ID, "c", "count", "Count", INTEGER_TYPE, 1 });
+    parser.addArgument({ OPTIONAL, NAME_ID, "n", "name", "Name", STRING_TYPE, 1 });
+
+    // A tiny buffer, so lines are split across reads and one has to grow it.
+    const std::string long_name(40, 'x');
+    const std::string input = "-v -c 1\n"
+                              "--count=22 --name=abc\r\n"
+                              "\n"
+                              "-c bad\n"
+                              "--name=" +
+                              long_name + "\n-v";
+
+    int fds[2];
+    CPPUNIT_ASSERT_EQUAL(0, pipe(fds));
+    CPPUNIT_ASSERT_EQUAL(static_cast<ssize_t>(input.size()), write(fds[1], input.data(), input.size()));
+    close(fds[1]);
+
+    std::vector<std::string> lines;
+    std::vector<int> counts;
+    std::vector<size_t> error_lines;
+    std::string last_name;
+    LineDispatcher dispatcher(
+      parser,
+      [&](Parser& p_parser, std::string_view p_line) {
+          lines.emplace_back(p_line);
+          if (p_parser.error()) {
+              error_lines.push_back(lines.size());
+              return true;
+          }
+          Results results = p_parser.getResults();
+          counts.push_back(results.has(COUNT_ID) ? results.get<int>(COUNT_ID) : 0);
+          if (results.has(NAME_ID))
+              last_name = results.get<std::string>(NAME_ID);
+          return true;
+      },
+      16);
+
+    CPPUNIT_ASSERT(dispatcher.run(fds[0]));
+    CPPUNIT_ASSERT(!dispatcher.readError());
+    close(fds[0]);
+
+    // The blank line is counted but not dispatched, and the last one needs no newline.
+    CPPUNIT_ASSERT_EQUAL(size_t(6), dispatcher.getLineNumber());
+    CPPUNIT_ASSERT_EQUAL(size_t(5), lines.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("--count=22 --name=abc"), lines[1]);
+    CPPUNIT_ASSERT_EQUAL(std::string("-v"), lines[4]);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), error_lines.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(3), error_lines[0]);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), counts.size());
+    CPPUNIT_ASSERT_EQUAL(1, counts[0]);
+    CPPUNIT_ASSERT_EQUAL(22, counts[1]);
+    CPPUNIT_ASSERT_EQUAL(long_name, last_name);
+
+    // A handler returning false stops the reading.
+    CPPUNIT_ASSERT_EQUAL(0, pipe(fds));
+    CPPUNIT_ASSERT_EQUAL(ssize_t(9), write(fds[1], "-v\n-v\n-v\n", 9));
+    close(fds[1]);
+
+    size_t calls = 0;
+    LineDispatcher stopper(parser, [&](Parser&, std::string_view) { return ++calls < 2; });
+    CPPUNIT_ASSERT(!stopper.run(fds[0]));
+    CPPUNIT_ASSERT(!stopper.readError());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), calls);
+    close(fds[0]);
+#endif
+}
+
+// The edit distance from the whole table, to check the bit-parallel one against.
+static size_t
+editDistance(const std::string& p_a, const std::string& p_b)
+{
+    std::vector<std::vector<size_t>> table(p_a.size() + 1, std::vector<size_t>(p_b.size() + 1));
+    for (size_t i = 0; i <= p_a.size(); ++i)
+        table[i][0] = i;
+    for (size_t j = 0; j <= p_b.size(); ++j)
+        table[0][j] = j;
+    for (size_t i = 1; i <= p_a.size(); ++i) {
+        for (size_t j = 1; j <= p_b.size(); ++j) {
+            const size_t cost = (p_a[i - 1] == p_b[j - 1]) ? 0 : 1;
+            table[i][j] = std::min({ table[i - 1][j] + 1, table[i][j - 1] + 1, table[i - 1][j - 1] + cost });
+        }
+    }
+    return table[p_a.size()][p_b.size()];
+}
+
+void
+ParserTests::testFlagSuggestions()
+{
+    // Random strings over a small alphabet, some longer than a machine word.
+    unsigned seed = 12345;
+    auto randomString = [&](size_t p_max_size) {
+        std::string str;
+        seed = seed * 1103515245 + 12345;
+        const size_t size = (seed >> 16) % (p_max_size + 1);
+        for (size_t i = 0; i < size; ++i) {
+            seed = seed * 1103515245 + 12345;
+            str += static_cast<char>('a' + (seed >> 16) % 4);
+        }
+        return str;
+    };
+    for (int i = 0; i < 500; ++i) {
+        const std::string a = randomString(i < 450 ? 20 : 90);
+        const std::string b = randomString(i < 450 ? 20 : 90);
+        CPPUNIT_ASSERT_EQUAL(editDistance(a, b), FlagSuggester::distance(a, b));
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(1), FlagSuggester::distance("Verbos", "verbose"));
+
+    const int VERBOSE_ID = 1;
+    const int THREADS_ID = 2;
+    const int OUTPUT_ID = 3;
+
+    Parser parser;
+    parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" });
+    parser.addArgument({ OPTIONAL, THREADS_ID, "t", "threads", "Threads", INTEGER_TYPE, 1 });
+    parser.addArgument({ OPTIONAL, OUTPUT_ID, "o", "output", "Output", STRING_TYPE, 1 });
+
+    parser.exec("--verbos");
+    CPPUNIT_ASSERT_EQUAL(UNRECOGNIZED_OPTION, parser.getErrorCode());
+    CPPUNIT_ASSERT_EQUAL(std::string("error: Unrecognized command-line option: --verbos (did you mean --verbose?)"),
+                         parser.getErrorMsg());
+
+    // Case is ignored, and nothing close means no suggestion.
+    parser.exec("--THREDS=4");
+    CPPUNIT_ASSERT_EQUAL(std::string("--threads"), std::string(parser.getDiagnostics()[0].suggestion));
+    parser.exec("--zzzzzz");
+    CPPUNIT_ASSERT(parser.getDiagnostics()[0].suggestion.empty());
+
+    std::vector<std::string_view> flags = parser.suggestFlags("--outptu", 2);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), flags.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("--output"), std::string(flags[0]));
+
+    // Suggestions can be turned off.
+    parser.setSuggestionBudget(std::chrono::microseconds(0));
+    parser.exec("--verbos");
+    CPPUNIT_ASSERT(parser.getDiagnostics()[0].suggestion.empty());
+
+    // Thousands of flags, with a budget big enough to look at all of them.
+    Parser big;
+    for (int i = 0; i < 5000; ++i) {
+        char name[32];
+        snprintf(name, sizeof(name), "option_%04d", i);
+        big.addArgument({ SWITCH, i + 1, DEFAULT_SHORT_FLAG_NAME, name, "An option" });
+    }
+    big.setSuggestionBudget(std::chrono::seconds(1));
+    flags = big.suggestFlags("--optoin_4321", 3);
+    CPPUNIT_ASSERT(!flags.empty());
+    CPPUNIT_ASSERT_EQUAL(std::string("--option_4321"), std::string(flags[0]));
+}
+
+// The arguments of the master and the worker in testResultsSnapshot.
+static void
+addSnapshotArguments(Parser& p_parser)
+{
+    p_parser.addArgument({ SWITCH, 1, "v", "verbose", "Verbose output" });
+    p_parser.addArgument({ OPTIONAL, 2, "t", "threads", "Threads", INTEGER_TYPE, 1 });
+    p_parser.addArgument({ OPTIONAL, 3, "r", "ratio", "Ratio", DOUBLE_TYPE, 1 });
+    p_parser.addArgument({ OPTIONAL, 4, "n", "name", "Name", STRING_TYPE, 1 });
+    p_parser.addArgument({ OPTIONAL, 5, "c", "cpus", "CPUs", INTEGER_LIST_TYPE, 1 });
+    p_parser.addArgument({ OPTIONAL, 6, "p", "port", "Port", INTEGER_TYPE, 1 })->setDefaultValue(8080);
+    p_parser.addArgument({ OPTIONAL, 7, "q", "quiet", "Unused", STRING_TYPE, 1 });
+}
+
+void
+ParserTests::testResultsSnapshot()
+{
+    Parser master;
+    addSnapshotArguments(master);
+    master.exec("-v --threads=8 -r 0.25 --name=a_worker_process_name --cpus=0-3,8");
+    CPPUNIT_ASSERT(!master.error());
+
+    // The worker gets the bytes through a pipe or shared memory.
+    const std::string blob = ResultsSnapshot::serialize(master);
+    std::vector<uint64_t> shared((blob.size() + 7) / 8);
+    memcpy(shared.data(), blob.data(), blob.size());
+    const std::string_view received(reinterpret_cast<const char*>(shared.data()), blob.size());
+
+    Parser worker;
+    addSnapshotArguments(worker);
+    CPPUNIT_ASSERT_EQUAL(ResultsSnapshot::fingerprint(master), ResultsSnapshot::fingerprint(worker));
+
+    ResultsSnapshot snapshot;
+    CPPUNIT_ASSERT(snapshot.open(received, ResultsSnapshot::fingerprint(worker)));
+    CPPUNIT_ASSERT(snapshot.verify());
+    CPPUNIT_ASSERT_EQUAL(size_t(6), snapshot.size());
+
+    // Reading the values doesn't allocate.
+    const size_t allocations = s_allocations;
+    const bool verbose = snapshot.has(1) && snapshot.get<bool>(1);
+    const int threads = snapshot.get<int>(2);
+    const double ratio = snapshot.get<double>(3);
+    const float ratio_float = snapshot.get<float>(3);
+    const std::string_view name = snapshot.get<std::string_view>(4);
+    const std::span<const int> cpus = snapshot.get<std::span<const int>>(5);
+    const int port = snapshot.get<int>(6);
+    const bool has_port = snapshot.has(6);
+    const ArgumentType port_source = snapshot.getSource(6);
+    const bool has_quiet = snapshot.has(7);
+    const size_t read_allocations = s_allocations - allocations;
+
+    CPPUNIT_ASSERT_EQUAL(size_t(0), read_allocations);
+    CPPUNIT_ASSERT(verbose);
+    CPPUNIT_ASSERT_EQUAL(8, threads);
+    CPPUNIT_ASSERT_EQUAL(0.25, ratio);
+    CPPUNIT_ASSERT_EQUAL(0.25f, ratio_float);
+    CPPUNIT_ASSERT_EQUAL(std::string("a_worker_process_name"), std::string(name));
+    CPPUNIT_ASSERT(name.data() >= received.data() && name.data() < received.data() + received.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(5), cpus.size());
+    CPPUNIT_ASSERT_EQUAL(8, cpus[4]);
+    CPPUNIT_ASSERT_EQUAL(8080, port);
+    CPPUNIT_ASSERT(!has_port);
+    CPPUNIT_ASSERT_EQUAL(DEFAULT_SOURCE, port_source);
+    CPPUNIT_ASSERT(!has_quiet);
+    CPPUNIT_ASSERT_EQUAL(NO_ARG, snapshot.getSource(7));
+
+    // A worker with other arguments, or a damaged buffer, is refused.
+    Parser other;
+    addSnapshotArguments(other);
+    other.addArgument({ OPTIONAL, 8, "x", "extra", "Extra", STRING_TYPE, 1 });
+    CPPUNIT_ASSERT(!snapshot.open(received, ResultsSnapshot::fingerprint(other)));
+    CPPUNIT_ASSERT(!snapshot.isOpen());
+    CPPUNIT_ASSERT(!snapshot.open(received.substr(0, received.size() - 8), ResultsSnapshot::fingerprint(worker)));
+
+    memcpy(shared.data(), blob.data(), blob.size());
+    reinterpret_cast<char*>(shared.data())[blob.size() - 1] ^= 1;
+    CPPUNIT_ASSERT(snapshot.open(received, ResultsSnapshot::fingerprint(worker)));
+    CPPUNIT_ASSERT(!snapshot.verify());
+
+    // A string offset so big that the end of the string wraps around to
+    // inside the pool. The header's records_offset is at byte 36, and each
+    // 24 byte record has its ID first and the offset at byte 16.
+    memcpy(shared.data(), blob.data(), blob.size());
+    char* bytes = reinterpret_cast<char*>(shared.data());
+    uint32_t records_offset = 0;
+    memcpy(&records_offset, bytes + 36, sizeof(records_offset));
+    for (char* record = bytes + records_offset; record + 24 <= bytes + blob.size(); record += 24) {
+        int32_t id = 0;
+        memcpy(&id, record, sizeof(id));
+        if (id == 4) {
+            const uint64_t wrapping_offset = ~uint64_t(7);
+            memcpy(record + 16, &wrapping_offset, sizeof(wrapping_offset));
+            break;
+        }
+    }
+    CPPUNIT_ASSERT(!snapshot.open(received, ResultsSnapshot::fingerprint(worker)));
+}
+
+// A reader that stalls between loading the parity and counting itself in.
+class ParkedReader : public OptionsStore::Reader
+{
+  public:
+    ParkedReader(const OptionsStore& p_store, unsigned p_parity)
+      : Reader(p_store, p_parity)
+    {
+    }
+
+    static unsigned loadParity(const OptionsStore& p_store) { return currentParity(p_store); }
+};
+
+void
+ParserTests::testOptionsStore()
+{
+    const int THREADS_ID = 1;
+    const int LIMIT_ID = 2;
+    const int NAME_ID = 3;
+
+    Parser parser;
+    parser.addArgument({ OPTIONAL, THREADS_ID, "t", "threads", "Threads", INTEGER_TYPE, 1 });
+    parser.addArgument({ OPTIONAL, LIMIT_ID, "l", "limit", "Twice the threads", INTEGER_TYPE, 1 });
+    parser.addArgument({ OPTIONAL, NAME_ID, "n", "name", "Name", STRING_TYPE, 1 });
+
+    OptionsStore store;
+    CPPUNIT_ASSERT(!store.read());
+
+    parser.exec("-t 1 -l 2 -n first");
+    std::vector<int> changed = store.publish(parser);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), changed.size());
+
+    // Only the options whose values differ are reported.
+    parser.exec("-t 1 -l 2 -n second");
+    changed = store.publish(parser);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), changed.size());
+    CPPUNIT_ASSERT_EQUAL(NAME_ID, changed[0]);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), store.getGeneration());
+
+    parser.exec("-t 1 -l 2");
+    changed = store.publish(parser);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), changed.size());
+    CPPUNIT_ASSERT_EQUAL(NAME_ID, changed[0]);
+    {
+        OptionsStore::Reader reader = store.read();
+        CPPUNIT_ASSERT(reader);
+        CPPUNIT_ASSERT_EQUAL(1, reader->getValues().get<int>(THREADS_ID));
+        CPPUNIT_ASSERT(!reader->getValues().has(NAME_ID));
+    }
+
+    // Readers always see a whole snapshot (limit is twice threads) while the
+    // writer keeps reloading.
+    std::atomic<bool> done{ false };
+    std::atomic<size_t> torn{ 0 };
+    std::atomic<size_t> reads{ 0 };
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            while (!done.load()) {
+                const OptionsStore::Reader reader = store.read();
+                const ResultsSnapshot& values = reader->getValues();
+                if (values.get<int>(LIMIT_ID) != 2 * values.get<int>(THREADS_ID))
+                    ++torn;
+                ++reads;
+            }
+        });
+    }
+
+    std::string line;
+    for (int threads = 2; threads < 200; ++threads) {
+        // Let the readers run between reloads, even on one core.
+        const size_t reads_before = reads.load();
+        while (reads.load() == reads_before)
+            std::this_thread::yield();
+
+        line = "-t " + std::to_string(threads) + " -l " + std::to_string(2 * threads);
+        parser.exec(line);
+        changed = store.publish(parser);
+        if (changed.size() != 2)
+            ++torn;
+    }
+
+    done = true;
+    for (std::thread& reader : readers)
+        reader.join();
+
+    CPPUNIT_ASSERT_EQUAL(size_t(0), torn.load());
+    CPPUNIT_ASSERT_EQUAL(199, store.read()->getValues().get<int>(THREADS_ID));
+
+    // Readers that load the parity before a publish and count themselves in
+    // after it keep the snapshot they load through the next publish.
+    size_t lost_snapshots = 0;
+    for (int round = 0; round < 20; ++round) {
+        unsigned parities[4];
+        for (unsigned& parity : parities)
+            parity = ParkedReader::loadParity(store);
+
+        line = "-t " + std::to_string(round) + " -l " + std::to_string(2 * round);
+        parser.exec(line);
+        store.publish(parser);
+
+        std::atomic<bool> published{ false };
+        std::thread writer;
+        {
+            std::vector<std::unique_ptr<ParkedReader>> parked;
+            for (unsigned parity : parities)
+                parked.push_back(std::make_unique<ParkedReader>(store, parity));
+
+            writer = std::thread([&]() {
+                parser.exec("-t 1000 -l 2000");
+                store.publish(parser);
+                published = true;
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            if (published.load())
+                ++lost_snapshots;
+
+            for (const std::unique_ptr<ParkedReader>& reader : parked) {
+                const ResultsSnapshot& values = (*reader)->getValues();
+                if (values.get<int>(THREADS_ID) != round || values.get<int>(LIMIT_ID) != 2 * round)
+                    ++lost_snapshots;
+            }
+        }
+        writer.join();
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(0), lost_snapshots);
+}
+
+// A value of either parser as text, to compare them.
+template<class Value_t>
+static std::string
+valueText(const Value_t& p_value)
+{
+    return std::visit(
+      [](const auto& p_alternative) -> std::string {
+          typedef std::decay_t<decltype(p_alternative)> Alternative_t;
+          if constexpr (std::is_same_v<Alternative_t, bool>)
+              return p_alternative ? "true" : "false";
+          else if constexpr (std::is_arithmetic_v<Alternative_t>)
+              return std::to_string(p_alternative);
+          else if constexpr (std::is_convertible_v<Alternative_t, std::string_view>)
+              return std::string(p_alternative);
+          else
+              return "";
+      },
+      p_value);
+}
+
+void
+ParserTests::testFixedParser()
+{
+    const int STR_ID = 1;
+    const int INTS_ID = 2;
+    const int DOUBLES_ID = 3;
+    const int VERBOSE_ID = 4;
+    const int BOOL_ID = 5;
+    const int ABOUT_ID = 6;
+    const int RATIO_ID = 7;
+    const int OUT_ID = 8;
+
+    Parser parser;
+    parser.addArgument({ OPTIONAL, STR_ID, "1", "one", "A string", STRING_TYPE, 1 });
+    parser.addArgument({ OPTIONAL, INTS_ID, "2", "two", "Two integers", INTEGER_TYPE, 2 });
+    parser.addArgument({ OPTIONAL, DOUBLES_ID, "3", "three", "Three doubles", DOUBLE_TYPE, 3 });
+    parser.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" });
+    parser.addArgument({ SWITCH, BOOL_ID, "b", "bool", "A switch with a value", BOOLEAN_TYPE, 1 });
+    parser.addArgument({ X_SWITCH, ABOUT_ID, "a", "about", "About the app" })->setFlagType(SLASH_FLAG);
+    parser.addArgument({ REQUIRED, RATIO_ID, "r", "ratio", "A ratio", FLOAT_TYPE });
+    parser.addArgument({ OPTIONAL, OUT_ID, "o", "out", "Output file" });
+
+    FixedParser<8, 16, 256> fixed;
+    fixed.addArgument({ OPTIONAL, STR_ID, "1", "one", "A string", STRING_TYPE, 1 });
+    fixed.addArgument({ OPTIONAL, INTS_ID, "2", "two", "Two integers", INTEGER_TYPE, 2 });
+    fixed.addArgument({ OPTIONAL, DOUBLES_ID, "3", "three", "Three doubles", DOUBLE_TYPE, 3 });
+    fixed.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" });
+    fixed.addArgument({ SWITCH, BOOL_ID, "b", "bool", "A switch with a value", BOOLEAN_TYPE, 1 });
+    fixed.addArgument({ X_SWITCH, ABOUT_ID, "a", "about", "About the app", DEFAULT_VALUE_TYPE, 0, SLASH_FLAG });
+    fixed.addArgument({ REQUIRED, RATIO_ID, "r", "ratio", "A ratio", FLOAT_TYPE });
+    fixed.addArgument({ OPTIONAL, OUT_ID, "o", "out", "Output file" });
+
+    const std::string_view lines[] = {
+        "-1=This_is_a_long_string",
+        "-1='This is =A= long string'",
+        "-1='This is a long string' -v",
+        "-1=(unclosed block -v",
+        "-v --verbose",
+        "-2=1337,1338 -3=1.5,2.5,3.5",
+        "-2=1337,13.38",
+        "-2=1337",
+        "-3=1,x,3",
+        "-v /a -1=x",
+        "/about",
+        "-a",
+        "--bool=off -b yes",
+        "-b maybe",
+        "-r 0.75 -v",
+        "--ratio=3.14 -1=last -1=again",
+        "-vo out.txt",
+        "-vofile.txt",
+        "-vz",
+        "-v -1",
+        "--bogus -v",
+        "-v -- -1=x",
+        "",
+    };
+
+    for (const std::string_view line : lines) {
+        const ParsedArguments_t expected = parser.exec(std::string(line));
+        const std::span<const FixedResult_t> results = fixed.exec(line);
+
+        const std::string context(line);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(context, parser.getErrorCode(), fixed.getErrorCode());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(context, parser.isMissingRequiredArgs(), fixed.isMissingRequiredArgs());
+        if (parser.error())
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(context, std::string(parser.getDiagnostics().front().token), std::string(fixed.getDiagnostic().token));
+
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(context, expected.size(), results.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(context, expected[i].first, results[i].first);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(context, valueText(expected[i].second), valueText(results[i].second));
+        }
+    }
+
+    // From argv, the elements are read as if they were joined with spaces.
+    char app[] = "app";
+    char str[] = "-1=(two words)";
+    char verbose[] = "-v";
+    char* argv[] = { app, str, verbose, nullptr };
+    fixed.exec(3, argv);
+    CPPUNIT_ASSERT(!fixed.error());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("two words"), fixed.get<std::string_view>(STR_ID));
+    CPPUNIT_ASSERT(fixed.get<bool>(VERBOSE_ID));
+
+    // The last value wins, and the string outlives the command line.
+    std::string line = "--ratio=0.5 -1=first -1=second";
+    fixed.exec(line);
+    line.assign(line.size(), 'x');
+    CPPUNIT_ASSERT_EQUAL(std::string_view("second"), fixed.get<std::string_view>(STR_ID));
+    CPPUNIT_ASSERT_EQUAL(0.5, fixed.get<double>(RATIO_ID));
+    CPPUNIT_ASSERT_EQUAL(0, fixed.get<int>(INTS_ID));
+
+    // A parse doesn't allocate. The asserts do, so only check afterwards.
+    const size_t allocations = s_allocations;
+    size_t failures = 0;
+    for (int repeat = 0; repeat < 100; ++repeat) {
+        for (const std::string_view parse_line : lines)
+            fixed.exec(parse_line);
+        if (fixed.exec("-r 0.25 -1='a b c' -2=1,2 -vo out.txt").size() != 5 || fixed.error())
+            ++failures;
+    }
+    const size_t parse_allocations = s_allocations - allocations;
+    CPPUNIT_ASSERT_EQUAL(size_t(0), failures);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), parse_allocations);
+
+    // Running out of room is an error, not an allocation.
+    FixedParser<1, 2, 8> small;
+    CPPUNIT_ASSERT(small.addArgument({ OPTIONAL, STR_ID, "1", "one", "A string" }) != nullptr);
+    small.exec("-1=abc");
+    CPPUNIT_ASSERT(!small.error());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("abc"), small.get<std::string_view>(STR_ID));
+
+    small.exec("-1=too_many_bytes");
+    CPPUNIT_ASSERT_EQUAL(CAPACITY_EXCEEDED, small.getErrorCode());
+    CPPUNIT_ASSERT_EQUAL(STR_ID, small.getDiagnostic().arg_ID);
+
+    small.exec("-1='a b c'");
+    CPPUNIT_ASSERT_EQUAL(CAPACITY_EXCEEDED, small.getErrorCode());
+
+    small.exec("-1=a -1=b");
+    CPPUNIT_ASSERT_EQUAL(CAPACITY_EXCEEDED, small.getErrorCode());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), small.getDiagnostic().position);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), small.getResults().size());
+
+    CPPUNIT_ASSERT(small.addArgument({ SWITCH, VERBOSE_ID, "v", "verbose", "Verbose output" }) == nullptr);
+    small.exec("-1=abc");
+    CPPUNIT_ASSERT_EQUAL(CAPACITY_EXCEEDED, small.getErrorCode());
+
+    // A cluster has more results than tokens.
+    FixedParser<3, 1, 8> cluster;
+    cluster.addArgument({ SWITCH, 1, "x" });
+    cluster.addArgument({ SWITCH, 2, "y" });
+    cluster.addArgument({ SWITCH, 3, "z" });
+    cluster.exec("-xy");
+    CPPUNIT_ASSERT(!cluster.error());
+    cluster.exec("-xyz");
+    CPPUNIT_ASSERT_EQUAL(CAPACITY_EXCEEDED, cluster.getErrorCode());
+    cout << __func__ << ": " << cluster.getDiagnostic().toString() << "\n";
+}
@@ -43,6 +43,31 @@ class ParserTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testMissingShortDashFlag);
     CPPUNIT_TEST(testMissingShortSlashFlag);
     CPPUNIT_TEST(testDefaultValues1);
+    CPPUNIT_TEST(testEnvFallback);
+    CPPUNIT_TEST(testConfigFile);
+    CPPUNIT_TEST(testCompiledSpec);
+    CPPUNIT_TEST(testGeneratedParser);
+    CPPUNIT_TEST(testDiagnostics);
+    CPPUNIT_TEST(testArgumentStream);
+    CPPUNIT_TEST(testShortFlagClusters);
+    CPPUNIT_TEST(testBoundArguments);
+    CPPUNIT_TEST(testResultsView);
+    CPPUNIT_TEST(testChoiceType);
+    CPPUNIT_TEST(testValidators);
+    CPPUNIT_TEST(testIntegerList);
+    CPPUNIT_TEST(testNoStaticInitializers);
+    CPPUNIT_TEST(testFlagStyles);
+    CPPUNIT_TEST(testIgnoreFlagCase);
+    CPPUNIT_TEST(testArgvOccurrences);
+    CPPUNIT_TEST(testMapArguments);
+    CPPUNIT_TEST(testPositionalArguments);
+    CPPUNIT_TEST(testPassthroughArguments);
+    CPPUNIT_TEST(testParseContext);
+    CPPUNIT_TEST(testLineDispatcher);
+    CPPUNIT_TEST(testFlagSuggestions);
+    CPPUNIT_TEST(testResultsSnapshot);
+    CPPUNIT_TEST(testOptionsStore);
+    CPPUNIT_TEST(testFixedParser);
     CPPUNIT_TEST_SUITE_END();
 
   public:
@@ -64,6 +89,31 @@ class ParserTests : public CppUnit::TestFixture
     void testMissingShortDashFlag();
     void testMissingShortSlashFlag();
     void testDefaultValues1();
+    void testEnvFallback();
+    void testConfigFile();
+    void testCompiledSpec();
+    void testGeneratedParser();
+    void testDiagnostics();
+    void testArgumentStream();
+    void testShortFlagClusters();
+    void testBoundArguments();
+    void testResultsView();
+    void testChoiceType();
+    void testValidators();
+    void testIntegerList();
+    void testNoStaticInitializers();
+    void testFlagStyles();
+    void testIgnoreFlagCase();
+    void testArgvOccurrences();
+    void testMapArguments();
+    void testPositionalArguments();
+    void testPassthroughArguments();
+    void testParseContext();
+    void testLineDispatcher();
+    void testFlagSuggestions();
+    void testResultsSnapshot();
+    void testOptionsStore();
+    void testFixedParser();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ParserTests);
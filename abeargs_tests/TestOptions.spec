@@ -0,0 +1,10 @@
+# Options for the generated parser tests.
+namespace test_gen
+options TestOptions
+
+switch   v verbose          "Verbose output"
+xswitch  h help             "Show this info"
+optional t threads int      "Number of threads" default=4
+optional r ratio   double   "Ratio" default=0.5
+optional n name    string   "A name"
+required 1 one     int      "Required argument 1"